@@ -0,0 +1,56 @@
+#pragma once
+#include <GL/glew.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+// An image ready for upload: RGBA8, bottom row first as GL expects, with its
+// whole mip chain (level 0 first, each level max(1, size >> level)).
+// The texels live either in pixels (just decoded) or in mapping (baked cache).
+struct DecodedImage {
+    std::string path;
+    int width, height;  // 0 if the file could not be loaded
+    int levels;
+
+    std::vector<unsigned char> pixels;
+    std::shared_ptr<MappedFile> mapping;
+    size_t mappingOffset; // where the texels start within mapping
+
+    // Texels of one mip level
+    const unsigned char* Level(int level) const;
+};
+
+// Loads every image concurrently, one worker per hardware thread (at most one
+// per image). A PNG with an up-to-date "<path>.texcache" next to it is mapped
+// from that file without decoding; otherwise it is decoded, its rows flipped
+// while copied out of stb_image, its mips are built and the cache is written
+// for the next start.
+// Results keep the order of paths. Needs no GL context.
+std::vector<DecodedImage> decodeImages(const std::vector<std::string>& paths);
+
+// Uploads every mip level as an edge-clamped, trilinear GL_TEXTURE_2D; 0 if the image failed to load
+unsigned int uploadTexture2D(const DecodedImage& image);
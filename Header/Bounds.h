@@ -0,0 +1,30 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Bounds of box after transform (Arvo's method - exact for the transformed box's AABB)
+inline AABB transformAABB(const AABB& box, const glm::mat4& m) {
+    glm::vec3 center = (box.min + box.max) * 0.5f;
+    glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+    glm::vec3 newCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+    glm::mat3 absM = glm::mat3(glm::abs(glm::vec3(m[0])), glm::abs(glm::vec3(m[1])), glm::abs(glm::vec3(m[2])));
+    glm::vec3 newExtent = absM * extent;
+
+    AABB out;
+    out.min = newCenter - newExtent;
+    out.max = newCenter + newExtent;
+    return out;
+}
+
+inline AABB mergeAABB(const AABB& a, const AABB& b) {
+    AABB out;
+    out.min = glm::min(a.min, b.min);
+    out.max = glm::max(a.max, b.max);
+    return out;
+}
@@ -1,24 +1,72 @@
 #pragma once
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <vector>
 #include "Constants.h"
 #include "Mesh.h"
+#include "InstanceRenderer.h"
+#include "Visibility.h"
+#include "Lod.h"
 
 class Building {
 public:
-    void DrawFloors(unsigned int shader, const Mesh& quad, const Mesh& box) const;
-    void DrawElevatorShaft(unsigned int shader, const Mesh& box) const;
-    void DrawElevatorCab(unsigned int shader, float elevatorY, float doorOpenAmount,
+    // LodSelector ids [0, LOD_OBJECTS) belong to the building's fixtures and plants
+    static const int LOD_FIXTURE_FIRST = 0;                      // rod, shade per floor
+    static const int LOD_CAB_FIXTURE_FIRST = 2 * NUM_FLOORS;     // rod, shade per cab
+    static const int LOD_PLANT_FIRST = LOD_CAB_FIXTURE_FIRST + 2 * NUM_CARS; // up to three parts per plant
+    static const int LOD_OBJECTS = LOD_PLANT_FIRST + 3 * NUM_FLOORS;
+
+    Building();
+
+    // Bakes floors, walls and the shafts into one world-space vertex buffer (needs a GL context)
+    void BuildStaticGeometry();
+    void DestroyStaticGeometry();
+
+    // Everything below only draws what the visible set allows
+    void DrawStatic(InstanceRenderer& renderer, const VisibleSet& visible) const;
+    void DrawLightFixtures(InstanceRenderer& renderer, const VisibleSet& visible,
+                           LodSelector& lod, const LodMesh& cylinder, const LodMesh& cone) const;
+
+    // One car of the bank, in its shaft at carShaftX(car); the caller decides visibility
+    void DrawElevatorCab(InstanceRenderer& renderer, int car, float elevatorY, float doorOpenAmount,
                          const Mesh& box, const Mesh& quad) const;
-    void DrawLightFixtures(unsigned int shader, float elevatorY,
-                           const Mesh& cylinder, const Mesh& sphere, const Mesh& cone) const;
-    void DrawPlants(unsigned int shader,
-                    const Mesh& cylinder, const Mesh& sphere, const Mesh& cone) const;
-    void DrawFloorNumbers(unsigned int shader, const Mesh& box, unsigned int* floorTextures) const;
+    void DrawCabFixture(InstanceRenderer& renderer, int car, float elevatorY,
+                        LodSelector& lod, const LodMesh& cylinder, const LodMesh& cone) const;
+    void DrawPlants(InstanceRenderer& renderer, const VisibleSet& visible, LodSelector& lod,
+                    const LodMesh& cylinder, const LodMesh& sphere, const LodMesh& cone) const;
+    void DrawFloorNumbers(InstanceRenderer& renderer, const Mesh& box, unsigned int floorTextureArray) const;
 
 private:
-    void setModelAndDraw(unsigned int shader, const Mesh& mesh, glm::mat4 model) const;
-    void setMaterial(unsigned int shader, glm::vec3 color) const;
-    void drawWall(unsigned int shader, const Mesh& box,
+    // Axis-aligned box with a flat colour, collected once and baked by BuildStaticGeometry
+    struct StaticBox {
+        int chunk;        // floor index, NUM_FLOORS for full-height shaft walls
+        glm::vec3 center;
+        glm::vec3 size;
+        glm::vec3 color;
+    };
+
+    // Own VAO rather than the mesh arena: position + normal + texcoord + color
+    unsigned int staticVAO, staticVBO, staticEBO;
+    int staticIndexCount;
+
+    // Cullable index range of the baked buffer
+    struct StaticChunk {
+        int firstIndex = 0;
+        int indexCount = 0;
+        AABB bounds;
+    };
+    std::vector<StaticChunk> staticChunks;
+
+    void collectFloors(std::vector<StaticBox>& out) const;
+    void collectShaft(std::vector<StaticBox>& out) const; // every shaft of the bank
+    void collectShaft(std::vector<StaticBox>& out, float shaftX) const;
+    void addBox(std::vector<StaticBox>& out, int chunk, glm::vec3 color,
+        glm::vec3 center, float width, float height, float depth) const;
+
+    void drawMesh(InstanceRenderer& renderer, const Mesh& mesh,
+        const glm::mat4& model, glm::vec3 color) const;
+    void drawLod(InstanceRenderer& renderer, LodSelector& lod, int lodId, const LodMesh& mesh,
+        const glm::mat4& model, glm::vec3 color) const;
+    void drawWall(InstanceRenderer& renderer, const Mesh& box, glm::vec3 color,
         glm::vec3 center, float width, float height, float depth) const;
 };
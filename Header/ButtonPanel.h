@@ -4,6 +4,7 @@
 #include <vector>
 #include "Constants.h"
 #include "Mesh.h"
+#include "InstanceRenderer.h"
 
 struct Button3D {
     glm::vec3 center;     // world position
@@ -22,12 +23,13 @@ public:
     std::vector<Button3D> buttons;
 
     void Init();
-    void UpdatePositions(float elevatorY);
+    void UpdatePositions(float carX, float elevatorY);
 
     // Returns button index or -1
     int Raycast(glm::vec3 rayOrigin, glm::vec3 rayDir, float maxDist = 3.0f) const;
 
-    void Draw(unsigned int shader, const Mesh& box, unsigned int* btnTextures) const;
+    // Queues all buttons in the double-sided pass; btn_<i> is layer i of the array
+    void Draw(InstanceRenderer& renderer, const Mesh& box, unsigned int btnTextureArray) const;
 
 private:
     // Local offsets from elevator center, computed once in Init
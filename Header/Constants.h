@@ -25,6 +25,11 @@ const float DOOR_OPEN_TIME = 5.0f;
 const float DOOR_WIDTH = 1.5f;
 const float DOOR_HEIGHT = 2.9f;
 
+// Elevator bank: NUM_CARS shafts side by side along the back wall, centred on SHAFT_CENTER_X
+const int NUM_CARS = 3;
+const float SHAFT_SPACING = ELEVATOR_WIDTH + 0.4f; // centre to centre
+inline float carShaftX(int car) { return SHAFT_CENTER_X + (car - (NUM_CARS - 1) * 0.5f) * SHAFT_SPACING; }
+
 // Player / camera
 const float PLAYER_HEIGHT = 1.7f;
 const float PLAYER_SPEED = 3.5f;
@@ -41,6 +46,19 @@ const float BUTTON_SPACING = 0.025f;
 
 // Floor names
 const char* const FLOOR_NAMES[] = { "SU", "PR", "1", "2", "3", "4", "5", "6" };
+const int LOBBY_FLOOR = 1; // PR, where people enter and leave the building
+
+// Mesh arena: 20-byte packed vertices (float3 position, 2_10_10_10 normal,
+// half2 texcoord) instead of 8 floats
+const bool COMPACT_MESH_VERTICES = true;
 
 // Lighting
-const int MAX_LIGHTS = 20;
+const int MAX_LIGHTS = 256;        // 256 * 64 bytes fills the minimum guaranteed uniform block
+const int LIGHT_BLOCK_BINDING = 0; // uniform buffer binding of LightBlock in basic.frag
+const float LIGHT_CUTOFF = 5.0f / 256.0f; // attenuation below which a light no longer counts
+const int LIGHT_LIST_SIZE = 4;     // per-instance light indices; busier objects fall back to the clusters
+
+// Clustered lighting grid (view-space tiles x exponential depth slices)
+const int CLUSTER_X = 16;
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
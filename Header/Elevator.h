@@ -2,6 +2,7 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include "Constants.h"
+#include "Scheduler.h"
 
 class Elevator {
 public:
@@ -22,11 +23,24 @@ public:
     int firstTargetFloor;
 
     std::vector<bool> floorRequests;
+    int direction; // +1 up, -1 down, 0 idle, as kept by the scheduler
 
     Elevator();
 
+    // Dispatch policy for the next floor (LOOK by default)
+    void SetScheduler(SchedulingPolicy policy);
+
     void Update(float deltaTime);
 
+    // Event-driven stepping for fixed steps of dt. Returns how many Update(dt)
+    // calls from now the next one is that does more than move the cab, the doors
+    // or the door timer (arrival, doors opening past AreDoorsOpen, doors timing out,
+    // doors closed for the next trip), or -1 when nothing is pending.
+    long long StepsToNextEvent(float dt) const;
+    // Same as steps calls of Update(dt), in constant time; only valid when no
+    // event falls inside them (steps < StepsToNextEvent(dt))
+    void SkipSteps(long long steps, float dt);
+
     void RequestFloor(int floor);
     void CloseDoors();
     void OpenDoors();
@@ -41,5 +55,9 @@ public:
     void CallToFloor(int floor);
 
 private:
-    int findNextFloor() const;
+    const Scheduler* scheduler;
+
+    int findNextFloor();
+    void startTowards(int floor);
+    void retarget();
 };
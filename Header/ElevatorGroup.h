@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "Elevator.h"
+#include "Scheduler.h"
+
+// A bank of cars sharing the hall calls. Cab requests go to one car directly;
+// a hall call made through CallToFloor goes to the car with the lowest cost:
+// its estimated time to arrive (finishing the current sweep first when the
+// floor is behind it, plus a door cycle per stop on the way) and a charge per
+// stop it already owes, so calls spread over the bank.
+class ElevatorGroup {
+public:
+    explicit ElevatorGroup(int carCount = NUM_CARS);
+
+    int CarCount() const { return (int)cars.size(); }
+    Elevator& Car(int index) { return cars[index]; }
+    const Elevator& Car(int index) const { return cars[index]; }
+
+    void SetScheduler(SchedulingPolicy policy);
+
+    // Assigns the hall call at floor to a car and returns its index (-1 for an invalid floor)
+    int CallToFloor(int floor);
+
+    // Cost of car serving a hall call at floor, in seconds
+    float CallCost(int car, int floor) const;
+
+    void Update(float deltaTime);
+
+    // Elevator::StepsToNextEvent / SkipSteps over the whole bank
+    long long StepsToNextEvent(float dt) const;
+    void SkipSteps(long long steps, float dt);
+
+private:
+    std::vector<Elevator> cars;
+};
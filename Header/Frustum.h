@@ -0,0 +1,15 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Bounds.h"
+
+// View frustum as six inward-facing planes, extracted from projection * view
+class Frustum {
+public:
+    void Update(const glm::mat4& viewProjection);
+
+    // False only if box lies completely outside one of the planes
+    bool IsVisible(const AABB& box) const;
+
+private:
+    glm::vec4 planes[6]; // xyz = normal, w = distance
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <GL/glew.h>
+
+// Thin cache over the GL state the renderer touches. Each call is forwarded
+// only when it changes what is bound or enabled, so callers can state what
+// they need without saving, restoring or unbinding around their draws.
+// All binds of these kinds must go through here, or the cache goes stale
+// (resetStateCache forgets everything after outside changes).
+
+struct GLStateStats {
+    int issued;   // calls forwarded to GL this frame
+    int filtered; // calls dropped as no-ops this frame
+};
+
+void stateUseProgram(unsigned int program);
+void stateBindVertexArray(unsigned int vao);
+// Binds texture on the given unit (0-based); target is GL_TEXTURE_2D, _2D_ARRAY or _BUFFER
+void stateBindTexture(int unit, GLenum target, unsigned int texture);
+// GL_DEPTH_TEST, GL_CULL_FACE and GL_BLEND are cached; other caps go straight through
+void stateSetEnabled(GLenum cap, bool enabled);
+bool stateIsEnabled(GLenum cap); // cached value when known, otherwise asks GL
+void stateBlendFunc(GLenum src, GLenum dst);
+
+void resetStateCache();
+void beginStateFrame(); // zeroes the counters
+const GLStateStats& getStateStats();
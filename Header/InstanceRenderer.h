@@ -0,0 +1,106 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Mesh.h"
+#include "ShaderProgram.h"
+#include "Frustum.h"
+#include "RenderStats.h"
+#include "Lighting.h"
+#include "StreamBuffer.h"
+
+// Per-instance attributes read by basic.vert (divisor 1)
+struct InstanceData {
+    glm::mat4 model;        // locations 5..8
+    glm::vec3 color;        // location 3
+    glm::vec4 emissive;     // location 4: rgb + strength
+    glm::mat3 normalMatrix; // locations 9..11, computed once per instance on the CPU
+    glm::uvec2 lightList;   // location 12: four 8-bit light indices, count (> LIGHT_LIST_SIZE = use clusters)
+    int textureLayer;       // location 13: layer of the batch's texture array, -1 = none
+};
+
+// Draw passes, submitted in this order
+enum RenderPass {
+    PASS_OPAQUE = 0,  // back faces culled (when culling is on)
+    PASS_DOUBLE_SIDED // culling off, e.g. the thin button boxes
+};
+
+// Per-frame render queue. Modules push instances during the frame; they are
+// collected per (pass, mesh, texture) and Flush draws each group with a single
+// instanced call, groups sorted by pass, state and distance and instances
+// nearest first. Arena meshes share one VAO, so consecutive groups need no
+// rebind; with ARB_base_instance they need no state change at all.
+class InstanceRenderer {
+public:
+    InstanceRenderer();
+
+    // Expects shader to be the bound program whenever Flush is called
+    void Init(const BasicShader& shader);
+    void Destroy();
+
+    // Resets the frame counters and the pass; instances outside frustum are dropped by Push
+    // (null = no culling) and the rest are sorted by their distance from viewPos.
+    // Each instance gets the lights touching its bounds (null = every instance uses the clusters).
+    void BeginFrame(const Frustum* frustum, const glm::vec3& viewPos, const LightManager* lights = nullptr);
+
+    // Pass of the instances pushed from now on
+    void SetPass(RenderPass pass) { currentPass = pass; }
+
+    // Frustum test for callers that cull their own geometry; updates the counters
+    bool IsVisible(const AABB& worldBounds);
+
+    // Queues one instance of mesh unless its transformed bounds are outside the frustum;
+    // texture 0 draws with the instance colour
+    void Push(const Mesh& mesh, const glm::mat4& model, glm::vec3 color,
+              glm::vec4 emissive = glm::vec4(0.0f), unsigned int texture = 0);
+
+    // Same, textured with one layer of a GL_TEXTURE_2D_ARRAY; all layers of an
+    // array share a batch, so a whole panel of labels is one draw with one bind
+    void PushLayer(const Mesh& mesh, const glm::mat4& model, glm::vec3 color, glm::vec4 emissive,
+                   unsigned int textureArray, int layer);
+
+    // Queues an instance of geometry outside the arena that carries its own
+    // per-vertex colour (location 3), e.g. the baked building
+    // (not culled - test ranges with IsVisible first; worldBounds picks its lights)
+    void PushVertexColored(unsigned int vao, int firstIndex, int indexCount, const glm::mat4& model,
+                           const AABB& worldBounds);
+
+    // Writes all queued instances with one map of the stream buffer and issues one
+    // draw per group, in sort order. Meant to be called once per frame, after every
+    // module has pushed; each call uses the next region of the stream buffer.
+    void Flush();
+
+    const RenderStats& Stats() const { return stats; }
+
+private:
+    struct Batch {
+        RenderPass pass;
+        unsigned int vao;
+        Mesh mesh;
+        unsigned int texture;
+        bool layered;     // texture is a GL_TEXTURE_2D_ARRAY, bound to unit 3
+        bool vertexColor;
+        std::vector<InstanceData> instances;
+        std::vector<float> depths; // distance of each instance's bounds from the viewer
+        float nearest;
+    };
+
+    StreamBuffer instanceStream;
+    int useTextureLoc;
+    const Frustum* frustum;
+    const LightManager* lightManager;
+    glm::vec3 viewPos;
+    RenderPass currentPass;
+    RenderStats stats;
+    std::vector<Batch> batches;
+    std::vector<std::pair<uint64_t, size_t>> drawOrder; // (sort key, batch)
+    std::vector<size_t> instanceOrder;
+    std::vector<unsigned int> attachedVAOs; // VAOs whose instance attributes point at offset 0
+
+    Batch& findBatch(unsigned int vao, const Mesh& mesh, unsigned int texture, bool layered, bool vertexColor);
+    void addInstance(Batch& batch, const InstanceData& inst, const AABB& worldBounds);
+    void bindInstanceAttributes(size_t firstInstance, bool vertexColor) const;
+    glm::uvec2 lightListFor(const AABB& worldBounds);
+};
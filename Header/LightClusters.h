@@ -0,0 +1,49 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Constants.h"
+#include "Lighting.h"
+#include "ShaderProgram.h"
+
+// Clustered forward lighting: the view frustum is split into CLUSTER_X * CLUSTER_Y
+// screen tiles and CLUSTER_Z exponential depth slices. Each cluster stores the
+// lights whose influence box touches it, so a fragment only shades those.
+class LightClusters {
+public:
+    LightClusters();
+
+    // Creates the grid and index buffer textures (needs a current GL context)
+    void Init();
+    void Destroy();
+
+    // Re-bins the active lights; skipped when neither the camera nor any light changed
+    void Update(const LightManager& lightManager, const glm::mat4& view, const glm::mat4& projection);
+
+    // Binds the cluster textures to units 1 and 2 and sets the slice uniforms
+    void Bind(const BasicShader& shader, int screenWidth, int screenHeight) const;
+
+    // Light references across all clusters after the last rebuild
+    int LightReferences() const { return (int)indices.size(); }
+
+private:
+    unsigned int gridBuffer, gridTexture;   // RG32UI (offset, count) per cluster
+    unsigned int indexBuffer, indexTexture; // R16UI light indices
+    size_t indexCapacity;
+
+    glm::mat4 lastView, lastProjection;
+    unsigned int lastVersion;
+    bool valid;
+
+    std::vector<unsigned int> grid;
+    std::vector<unsigned short> indices;
+
+    // Cluster range covered by one light, inclusive
+    struct LightRange {
+        int light;
+        int x0, x1, y0, y1, z0, z1;
+    };
+    std::vector<LightRange> ranges;
+
+    bool computeRange(const AABB& box, const glm::mat4& view, const glm::mat4& projection, LightRange& out) const;
+};
@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "Constants.h"
+#include "Bounds.h"
 
 struct PointLight {
     glm::vec3 position;
@@ -13,19 +14,65 @@ struct PointLight {
     float linear;
     float quadratic;
     bool active;
+
+    // Optional box the light cannot shine out of (a floor light stays on its floor)
+    bool clipped;
+    AABB clipBounds;
+};
+
+// Mirrors struct Light in Shaders/basic.frag under std140 rules:
+// every vec3 is padded to 16 bytes, so a scalar is packed into each slot.
+struct GpuLight {
+    glm::vec3 position;
+    float constant;
+    glm::vec3 ambient;
+    float linear;
+    glm::vec3 diffuse;
+    float quadratic;
+    glm::vec3 specular;
+    int active;
 };
 
 class LightManager {
 public:
     std::vector<PointLight> lights;
 
+    LightManager();
+
+    // Creates the LightBlock uniform buffer (needs a current GL context)
+    void Init();
+    void Destroy();
+
     // Returns light index
     int AddFloorLight(int floorIndex);
-    int AddElevatorLight(float elevatorY);
+    int AddElevatorLight(float carX, float elevatorY);
     int AddButtonGlow(glm::vec3 position);
 
     void UpdateLightPosition(int index, glm::vec3 newPos);
     void SetLightActive(int index, bool active);
 
-    void UploadToShader(unsigned int shaderProgram) const;
+    // Re-uploads only the lights changed since the last call
+    void Upload();
+
+    // Distance at which attenuation drops below LIGHT_CUTOFF
+    float EffectiveRadius(int index) const;
+    // World-space box the light can affect (radius box, clipped to clipBounds)
+    AABB InfluenceBounds(int index) const;
+
+    // Writes up to maxCount active lights whose influence touches box into out.
+    // Returns how many were found, stopping at maxCount + 1 so overflow is visible.
+    int LightsAffecting(const AABB& box, int* out, int maxCount) const;
+
+    // Incremented on every change, so dependents can tell when to rebuild
+    unsigned int Version() const { return version; }
+
+private:
+    unsigned int ubo;
+    int dirtyBegin, dirtyEnd; // [begin, end) range of changed lights
+    unsigned int version;
+    std::vector<GpuLight> staging;
+    std::vector<AABB> influence; // InfluenceBounds per light, refreshed in markDirty
+
+    int addLight(const PointLight& light);
+    void markDirty(int index);
 };
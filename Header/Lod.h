@@ -0,0 +1,32 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include "Mesh.h"
+
+const int LOD_LEVELS = 3;
+
+// One primitive at decreasing tessellation; levels[0] is the finest
+struct LodMesh {
+    Mesh levels[LOD_LEVELS];
+};
+
+LodMesh createCylinderLods(); // 16, 10, 6 segments
+LodMesh createSphereLods();   // 12x24, 8x16, 5x10 rings x segments
+LodMesh createConeLods();     // 16, 10, 6 segments
+
+// Picks a level by projected screen size. Each drawn object passes a stable id;
+// its last level is remembered so it only changes once the size moves clearly
+// past a threshold (hysteresis), instead of flickering on the boundary.
+class LodSelector {
+public:
+    LodSelector();
+
+    void BeginFrame(glm::vec3 cameraPos, float fovYDegrees, int screenHeight);
+
+    const Mesh& Select(const LodMesh& lods, int id, const glm::mat4& model);
+
+private:
+    glm::vec3 cameraPos;
+    float pixelsPerUnit; // projected size of 1 unit at distance 1
+    std::vector<int> current; // per id, -1 = not seen yet
+};
@@ -1,12 +1,26 @@
 #pragma once
 #include <GL/glew.h>
+#include <cstddef>
+#include "Bounds.h"
 
+// A mesh is a range inside the shared geometry arena. Bind getMeshArenaVAO()
+// once and draw any mesh with glDrawElementsBaseVertex - no VAO switches.
 struct Mesh {
-    unsigned int VAO, VBO, EBO;
+    int baseVertex;
+    int firstIndex;         // in units of indexType
     int indexCount;
+    unsigned int indexType; // GL_UNSIGNED_SHORT when the mesh has few enough vertices
+    AABB bounds; // local-space bounds, for culling
 };
 
-// All meshes use vertex layout: position(3f) + normal(3f) + texcoord(2f)
+// Byte offset of the mesh's first index, for glDrawElements*
+inline const void* meshIndexOffset(const Mesh& mesh) {
+    size_t size = mesh.indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    return (const void*)(mesh.firstIndex * size);
+}
+
+// All meshes are generated as position(3f) + normal(3f) + texcoord(2f); the arena
+// stores them packed when COMPACT_MESH_VERTICES is set (attributes stay at locations 0..2)
 // All meshes are unit-sized, centered at origin. Scale with model matrix.
 
 Mesh createQuadMesh();       // 1x1 quad on XZ plane at Y=0, normal +Y
@@ -14,4 +28,11 @@ Mesh createBoxMesh();        // 1x1x1 cube, normals outward
 Mesh createCylinderMesh(int segments = 16);  // radius 1, height 1, along Y
 Mesh createSphereMesh(int rings = 12, int segments = 24); // radius 1
 Mesh createConeMesh(int segments = 16);  // base radius 1, height 1, along Y
-void deleteMesh(Mesh& mesh);
+
+// Uploads every mesh created so far into the arena buffers (call after the create* calls)
+void uploadMeshArena();
+unsigned int getMeshArenaVAO();
+void deleteMeshArena();
+
+// Draws mesh from the arena; the arena VAO must be bound
+void drawMeshElements(const Mesh& mesh);
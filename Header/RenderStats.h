@@ -0,0 +1,11 @@
+#pragma once
+
+// Per-frame renderer counters, printed with F3 for benchmarking
+struct RenderStats {
+    int objectsVisible;
+    int objectsCulled;
+    int drawCalls;
+    int instances;
+    int triangles;   // submitted this frame, after LOD selection
+    int lightListed; // instances shaded from their own light list rather than a cluster
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+
+// Dispatch policies for picking the next floor a car serves
+enum SchedulingPolicy {
+    SCHEDULE_LOWEST = 0, // lowest requested floor first (the original behaviour)
+    SCHEDULE_LOOK,       // keep going while requests lie ahead, then turn around
+    SCHEDULE_SCAN,       // like LOOK, but run to the end of the shaft before turning
+    SCHEDULE_NEAREST,    // closest request, ties broken towards the travel direction
+    SCHEDULE_COUNT
+};
+
+// Picks the next floor to serve from the pending requests.
+// position is the cab's height in floors (fractional between floors);
+// direction is +1 up, -1 down or 0 idle, and is updated to the new heading.
+// Returns -1 (and direction 0) when nothing is pending.
+class Scheduler {
+public:
+    virtual ~Scheduler() {}
+    virtual const char* Name() const = 0;
+    virtual int NextFloor(const std::vector<bool>& requests, float position, int& direction) const = 0;
+};
+
+// Shared stateless instance for policy
+const Scheduler* getScheduler(SchedulingPolicy policy);
@@ -0,0 +1,10 @@
+#pragma once
+#include <GL/glew.h>
+
+// Drop-in replacement for createShader that keeps the linked program binary
+// next to the executable (<vertex shader name>.progbin). The file is keyed by a
+// hash of both sources and the driver's vendor, renderer and version strings;
+// on a match the program is loaded without compiling. A missing, stale or
+// rejected binary falls back to a full compile and rewrites the file.
+// Without ARB_get_program_binary this is plain createShader.
+unsigned int createShaderCached(const char* vsSource, const char* fsSource);
@@ -0,0 +1,44 @@
+#pragma once
+#include <GL/glew.h>
+
+// Shader programs with their uniform locations resolved once after link,
+// so draw code never calls glGetUniformLocation by name.
+
+struct BasicShader {
+    unsigned int id;
+
+    // basic.vert (model matrix comes per instance)
+    int view;
+    int projection;
+
+    // basic.frag
+    int useTexture;
+    int diffuseTexture;
+    int labelTextures;
+    int materialSpecular;
+    int materialShininess;
+    int alpha;
+    int viewPos;
+
+    // Light clusters (see LightClusters)
+    int clusterGrid;
+    int clusterLights;
+    int clusterTileScale;
+    int clusterSliceScale;
+    int clusterSliceBias;
+};
+
+struct HudShader {
+    unsigned int id;
+
+    int model;
+    int uTexture;
+    int uTextureArray;
+    int uLayer;
+    int uAlpha;
+    int uIsTexture;
+    int uColor;
+};
+
+BasicShader createBasicShader(const char* vsSource, const char* fsSource);
+HudShader createHudShader(const char* vsSource, const char* fsSource);
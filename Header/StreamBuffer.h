@@ -0,0 +1,38 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+
+// Triple-buffered streaming buffer for data rewritten every frame. The buffer is
+// split into three regions used in turn; each is written through an unsynchronized
+// map and fenced after its draws, so the CPU only waits when the GPU is still
+// reading a region from three uses ago. No orphaning, no copy through the driver.
+class StreamBuffer {
+public:
+    StreamBuffer();
+
+    void Init(GLenum target);
+    void Destroy();
+
+    // Maps bytes at the start of the current region for writing (binds the buffer).
+    // Regions grow to fit, which discards the old storage. Null if the map failed.
+    void* Map(size_t bytes);
+    void Unmap();
+
+    // Fences the current region after the draws reading it and moves to the next
+    void Advance();
+
+    unsigned int Id() const { return buffer; }
+    size_t RegionOffset() const { return region * regionSize; } // in bytes, of the current region
+    size_t RegionSize() const { return regionSize; }
+
+    static const int REGIONS = 3;
+
+private:
+    unsigned int buffer;
+    GLenum target;
+    size_t regionSize;
+    int region;
+    GLsync fences[REGIONS];
+
+    void waitFor(int r);
+};
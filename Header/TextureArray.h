@@ -0,0 +1,8 @@
+#pragma once
+#include <GL/glew.h>
+#include "AssetLoader.h"
+
+// Uploads count same-sized decoded images into the layers of one
+// GL_TEXTURE_2D_ARRAY (RGBA8, clamped), in order, with the mips they carry.
+// Returns 0 if any image failed to load or its size differs from the first.
+unsigned int createTextureArray(const DecodedImage* images, int count);
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include "ElevatorGroup.h"
+
+// One passenger showing up at origin at time (seconds) and going to destination
+struct PassengerArrival {
+    double time;
+    int origin;
+    int destination;
+};
+
+// Office traffic patterns. Trips are incoming (lobby up to a floor), outgoing
+// (a floor down to the lobby) or inter-floor (between two other floors).
+enum TrafficProfile {
+    TRAFFIC_INTERFLOOR = 0, // inter-floor only, constant rate
+    TRAFFIC_UP_PEAK,        // morning: mostly incoming
+    TRAFFIC_LUNCH,          // out and back in at once, some inter-floor
+    TRAFFIC_DOWN_PEAK,      // evening: mostly outgoing
+    TRAFFIC_DAY,            // time of day from midnight: up-peak, lunch and down-peak
+                            // around 8, 12 and 17 h, quiet at night
+    TRAFFIC_COUNT
+};
+
+const char* trafficProfileName(TrafficProfile profile);
+
+// Poisson arrivals over [0, duration) at ratePerHour passengers an hour (scaled
+// over the day for TRAFFIC_DAY, sampled by thinning), in time order. The same
+// seed gives the same passengers.
+std::vector<PassengerArrival> generateTraffic(TrafficProfile profile, double duration,
+                                              double ratePerHour, unsigned int seed);
+
+// Feeds passengers to a bank of cars. Each arrival is a hall call at its origin;
+// the passenger boards the car the call went to once it stands there with doors
+// open, presses the destination (RequestFloor) and leaves when the car opens there.
+class PassengerFlow {
+public:
+    std::vector<double> waitTimes;    // arrival to boarding, per boarded passenger
+    std::vector<double> journeyTimes; // arrival to leaving the car, per delivered passenger
+
+    PassengerFlow(const std::vector<PassengerArrival>& arrivals, int carCount);
+
+    // Hall calls for everyone who has arrived by now
+    void Issue(ElevatorGroup& group, double now);
+    // Boarding and leaving at every car standing at a floor with doors open
+    void Exchange(ElevatorGroup& group, double now);
+
+    // Time of the next passenger still to arrive, -1 when all have
+    double NextArrival() const;
+    int Issued() const { return (int)nextArrival; }
+    int Delivered() const { return (int)journeyTimes.size(); }
+
+private:
+    std::vector<PassengerArrival> arrivals;
+    size_t nextArrival;
+    int carCount;
+    // Passenger indices per car * NUM_FLOORS + floor: origin while waiting, destination while riding
+    std::vector<std::vector<int>> waiting;
+    std::vector<std::vector<int>> riding;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include "Constants.h"
+
+// What can possibly be seen from one player situation. The floor slabs fully
+// separate the floors, so at most one floor's room is ever visible.
+struct VisibleSet {
+    int firstFloor, lastFloor; // inclusive range of floor rooms to draw (empty if first > last)
+    bool shaft;                // full-height shaft walls
+    bool cab;                  // elevator cab, its fixture, bulb, panel and display
+};
+
+// Potentially-visible sets keyed by (floor, inElevator, doorsOpen), precomputed once.
+// floor is the player's floor, or the cab's floor while the player rides it.
+class VisibilityTable {
+public:
+    void Build();
+    const VisibleSet& Query(int floor, bool inElevator, bool doorsOpen) const;
+
+private:
+    std::vector<VisibleSet> sets;
+
+    static int key(int floor, bool inElevator, bool doorsOpen);
+};
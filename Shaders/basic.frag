@@ -3,39 +3,52 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+in vec3 VertexColor;
+in vec3 Emissive;
+in float ViewDepth;
+flat in uvec2 LightList; // per-object lights from InstanceRenderer
+flat in int TextureLayer;
 
 out vec4 FragColor;
 
 // Material
 uniform bool useTexture;
 uniform sampler2D diffuseTexture;
-uniform vec3 solidColor;
+uniform sampler2DArray labelTextures; // button and floor labels, one per layer
 uniform vec3 materialSpecular;
 uniform float materialShininess;
 uniform float alpha;
 
-// Emissive (for glowing buttons)
-uniform vec3 emissiveColor;
-uniform float emissiveStrength;
-
 // Camera
 uniform vec3 viewPos;
 
-// Lights
+// Lights - std140 layout mirrored by GpuLight in Header/Lighting.h
 struct Light {
     vec3 position;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
     float constant;
+    vec3 ambient;
     float linear;
+    vec3 diffuse;
     float quadratic;
+    vec3 specular;
     bool active;
 };
 
-#define MAX_LIGHTS 20
-uniform int numLights;
-uniform Light lights[MAX_LIGHTS];
+#define MAX_LIGHTS 256
+layout(std140) uniform LightBlock {
+    Light lights[MAX_LIGHTS];
+};
+
+// Light clusters - built by LightClusters on the CPU
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define LIGHT_LIST_SIZE 4
+uniform usamplerBuffer clusterGrid;   // (offset, count) per cluster
+uniform usamplerBuffer clusterLights; // light indices
+uniform vec2 clusterTileScale;        // tiles per pixel
+uniform float clusterSliceScale;
+uniform float clusterSliceBias;
 
 vec3 CalcPointLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffColor)
 {
@@ -68,22 +81,42 @@ void main()
         norm = -norm;
 
     vec3 diffColor;
-    if (useTexture)
+    if (TextureLayer >= 0)
+        diffColor = texture(labelTextures, vec3(TexCoord, float(TextureLayer))).rgb;
+    else if (useTexture)
         diffColor = texture(diffuseTexture, TexCoord).rgb;
     else
-        diffColor = solidColor;
+        diffColor = VertexColor;
 
     // Global ambient so nothing is fully black
     vec3 result = vec3(0.08) * diffColor;
 
-    for (int i = 0; i < numLights && i < MAX_LIGHTS; i++)
+    if (LightList.y <= uint(LIGHT_LIST_SIZE))
+    {
+        // The few lights that reach this object, one byte each
+        for (uint i = 0u; i < LightList.y; i++)
+        {
+            int index = int((LightList.x >> (8u * i)) & 0xFFu);
+            result += CalcPointLight(lights[index], norm, FragPos, viewDir, diffColor);
+        }
+    }
+    else
     {
-        if (lights[i].active)
-            result += CalcPointLight(lights[i], norm, FragPos, viewDir, diffColor);
+        // Too many for the instance: only the lights binned into this fragment's cluster
+        ivec2 tile = min(ivec2(gl_FragCoord.xy * clusterTileScale), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+        int slice = clamp(int(log(max(ViewDepth, 1e-4)) * clusterSliceScale + clusterSliceBias), 0, CLUSTER_Z - 1);
+        int cluster = (slice * CLUSTER_Y + tile.y) * CLUSTER_X + tile.x;
+        uvec2 range = texelFetch(clusterGrid, cluster).xy;
+
+        for (uint i = 0u; i < range.y; i++)
+        {
+            int index = int(texelFetch(clusterLights, int(range.x + i)).r);
+            result += CalcPointLight(lights[index], norm, FragPos, viewDir, diffColor);
+        }
     }
 
-    // Add emissive
-    result += emissiveColor * emissiveStrength;
+    // Add emissive (per instance, for glowing buttons and bulbs)
+    result += Emissive;
 
     FragColor = vec4(result, alpha);
 }
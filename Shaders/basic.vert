@@ -4,18 +4,36 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
+// Per instance (see InstanceData); the baked static building feeds aColor per vertex
+layout(location = 3) in vec3 aColor;
+layout(location = 4) in vec4 aEmissive; // rgb + strength
+layout(location = 5) in mat4 aModel;    // locations 5..8
+layout(location = 9) in mat3 aNormalMatrix; // locations 9..11, inverse-transpose built on the CPU
+layout(location = 12) in uvec2 aLightList;  // packed light indices, count
+layout(location = 13) in int aTextureLayer; // layer of labelTextures, -1 = none
+
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+out vec3 VertexColor;
+out vec3 Emissive;
+out float ViewDepth; // positive distance along the view axis, for cluster lookup
+flat out uvec2 LightList;
+flat out int TextureLayer;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    Normal = aNormalMatrix * aNormal;
     TexCoord = aTexCoord;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    VertexColor = aColor;
+    Emissive = aEmissive.rgb * aEmissive.a;
+    LightList = aLightList;
+    TextureLayer = aTextureLayer;
+    vec4 viewSpace = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewSpace.z;
+    gl_Position = projection * viewSpace;
 }
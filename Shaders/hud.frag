@@ -4,6 +4,8 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 uniform sampler2D uTexture;
+uniform sampler2DArray uTextureArray;
+uniform int uLayer; // >= 0: sample this layer of uTextureArray instead of uTexture
 uniform float uAlpha;
 uniform bool uIsTexture;
 uniform vec3 uColor;
@@ -11,7 +13,9 @@ uniform vec3 uColor;
 void main()
 {
     if (uIsTexture) {
-        vec4 texColor = texture(uTexture, TexCoord);
+        vec4 texColor = uLayer >= 0
+            ? texture(uTextureArray, vec3(TexCoord, float(uLayer)))
+            : texture(uTexture, TexCoord);
         FragColor = vec4(texColor.rgb, texColor.a * uAlpha);
     } else {
         FragColor = vec4(uColor, uAlpha);
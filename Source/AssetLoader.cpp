@@ -0,0 +1,278 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/AssetLoader.h"
+#include "../Header/GLState.h"
+#include "../Header/stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ============ MAPPED FILE ============
+MappedFile::MappedFile()
+    : data(nullptr), size(0)
+#ifdef _WIN32
+    , fileHandle(INVALID_HANDLE_VALUE), mappingHandle(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        Close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle == NULL) {
+        Close();
+        return false;
+    }
+    data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    data = (const unsigned char*)view;
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != NULL) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data != nullptr) munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// ============ BAKED TEXTURE CACHE ============
+static const uint32_t TEXCACHE_MAGIC = 0x58455442; // "BTEX"
+static const uint32_t TEXCACHE_VERSION = 1;
+
+// Followed by the RGBA8 mip chain, already flipped for GL
+struct TexCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceSize;  // the PNG it was baked from, to notice edits
+    int64_t sourceTime;
+    int32_t width, height;
+    int32_t levels;
+    int32_t reserved;
+};
+
+static size_t levelBytes(int width, int height, int level) {
+    return (size_t)std::max(1, width >> level) * std::max(1, height >> level) * 4;
+}
+
+static size_t chainBytes(int width, int height, int levels) {
+    size_t total = 0;
+    for (int l = 0; l < levels; l++)
+        total += levelBytes(width, height, l);
+    return total;
+}
+
+const unsigned char* DecodedImage::Level(int level) const {
+    const unsigned char* base = mapping ? mapping->Data() + mappingOffset : pixels.data();
+    for (int l = 0; l < level; l++)
+        base += levelBytes(width, height, l);
+    return base;
+}
+
+static bool sourceStamp(const std::string& path, uint64_t& size, int64_t& time) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = (uint64_t)st.st_size;
+    time = (int64_t)st.st_mtime;
+    return true;
+}
+
+static bool loadBaked(DecodedImage& out, uint64_t sourceSize, int64_t sourceTime) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->Open(out.path + ".texcache") || file->Size() < sizeof(TexCacheHeader)) return false;
+
+    TexCacheHeader header;
+    memcpy(&header, file->Data(), sizeof(header));
+    if (header.magic != TEXCACHE_MAGIC || header.version != TEXCACHE_VERSION ||
+        header.sourceSize != sourceSize || header.sourceTime != sourceTime ||
+        header.width <= 0 || header.height <= 0 || header.levels <= 0)
+        return false;
+    if (file->Size() < sizeof(header) + chainBytes(header.width, header.height, header.levels))
+        return false; // truncated
+
+    out.width = header.width;
+    out.height = header.height;
+    out.levels = header.levels;
+    out.mapping = file;
+    out.mappingOffset = sizeof(header);
+    return true;
+}
+
+static void saveBaked(const DecodedImage& image, uint64_t sourceSize, int64_t sourceTime) {
+    TexCacheHeader header;
+    header.magic = TEXCACHE_MAGIC;
+    header.version = TEXCACHE_VERSION;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.width = image.width;
+    header.height = image.height;
+    header.levels = image.levels;
+    header.reserved = 0;
+
+    std::string path = image.path + ".texcache";
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == NULL) return; // read-only install: keep decoding every start
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(image.pixels.data(), 1, image.pixels.size(), f) == image.pixels.size();
+    fclose(f);
+    if (!ok) remove(path.c_str());
+}
+
+// Appends the mip chain below level 0 with a 2x2 box filter (same as glGenerateMipmap)
+static void buildMips(DecodedImage& image) {
+    image.levels = 1;
+    while ((image.width >> image.levels) > 0 || (image.height >> image.levels) > 0)
+        image.levels++;
+    image.pixels.resize(chainBytes(image.width, image.height, image.levels));
+
+    size_t srcOffset = 0;
+    for (int l = 1; l < image.levels; l++) {
+        int sw = std::max(1, image.width >> (l - 1)), sh = std::max(1, image.height >> (l - 1));
+        int dw = std::max(1, image.width >> l), dh = std::max(1, image.height >> l);
+        size_t dstOffset = srcOffset + levelBytes(image.width, image.height, l - 1);
+        const unsigned char* src = &image.pixels[srcOffset];
+        unsigned char* dst = &image.pixels[dstOffset];
+
+        for (int y = 0; y < dh; y++) {
+            int y0 = std::min(y * 2, sh - 1), y1 = std::min(y * 2 + 1, sh - 1);
+            for (int x = 0; x < dw; x++) {
+                int x0 = std::min(x * 2, sw - 1), x1 = std::min(x * 2 + 1, sw - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src[(y0 * sw + x0) * 4 + c] + src[(y0 * sw + x1) * 4 + c] +
+                              src[(y1 * sw + x0) * 4 + c] + src[(y1 * sw + x1) * 4 + c];
+                    dst[(y * dw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        srcOffset = dstOffset;
+    }
+}
+
+// ============ LOADING ============
+static void decodeOne(DecodedImage& out) {
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    bool stamped = sourceStamp(out.path, sourceSize, sourceTime);
+    if (stamped && loadBaked(out, sourceSize, sourceTime)) return;
+
+    int w, h, channels;
+    unsigned char* data = stbi_load(out.path.c_str(), &w, &h, &channels, 4);
+    if (data == NULL) {
+        out.width = out.height = 0;
+        return;
+    }
+    out.width = w;
+    out.height = h;
+    // Rows bottom-up for GL, flipped in the one copy out of stb's buffer
+    size_t rowBytes = (size_t)w * 4;
+    out.pixels.resize(rowBytes * h);
+    for (int y = 0; y < h; y++)
+        memcpy(&out.pixels[rowBytes * y], data + rowBytes * (h - 1 - y), rowBytes);
+    stbi_image_free(data);
+
+    buildMips(out);
+    if (stamped) saveBaked(out, sourceSize, sourceTime);
+}
+
+std::vector<DecodedImage> decodeImages(const std::vector<std::string>& paths) {
+    std::vector<DecodedImage> images(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        images[i].path = paths[i];
+        images[i].width = images[i].height = 0;
+        images[i].levels = 0;
+        images[i].mappingOffset = 0;
+    }
+
+    // Workers pull the next image index until none are left
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < images.size(); i = next++)
+            decodeOne(images[i]);
+    };
+
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, images.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; t++)
+        threads.emplace_back(worker);
+    worker(); // the calling thread works too
+    for (std::thread& t : threads)
+        t.join();
+
+    for (const DecodedImage& image : images) {
+        if (image.width == 0)
+            std::cout << "Textura nije ucitana! Putanja texture: " << image.path << std::endl;
+    }
+    return images;
+}
+
+unsigned int uploadTexture2D(const DecodedImage& image) {
+    if (image.width == 0) return 0;
+
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    stateBindTexture(0, GL_TEXTURE_2D, tex);
+    for (int l = 0; l < image.levels; l++) {
+        glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, std::max(1, image.width >> l), std::max(1, image.height >> l), 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, image.Level(l));
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return tex;
+}
@@ -1,218 +1,324 @@
 #include "../Header/Building.h"
+#include "../Header/GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 
-void Building::setModelAndDraw(unsigned int shader, const Mesh& mesh, glm::mat4 model) const {
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(mesh.VAO);
-    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+Building::Building()
+    : staticVAO(0), staticVBO(0), staticEBO(0), staticIndexCount(0)
+{
 }
 
-void Building::setMaterial(unsigned int shader, glm::vec3 color) const {
-    glUniform3fv(glGetUniformLocation(shader, "solidColor"), 1, glm::value_ptr(color));
-    glUniform1i(glGetUniformLocation(shader, "useTexture"), 0);
+void Building::drawMesh(InstanceRenderer& renderer, const Mesh& mesh,
+    const glm::mat4& model, glm::vec3 color) const {
+    renderer.Push(mesh, model, color);
+}
+
+void Building::drawLod(InstanceRenderer& renderer, LodSelector& lod, int lodId, const LodMesh& mesh,
+    const glm::mat4& model, glm::vec3 color) const {
+    renderer.Push(lod.Select(mesh, lodId, model), model, color);
 }
 
 // Helper: draw a wall as a thin box so both sides are visible
-void Building::drawWall(unsigned int shader, const Mesh& box,
+void Building::drawWall(InstanceRenderer& renderer, const Mesh& box, glm::vec3 color,
     glm::vec3 center, float width, float height, float depth) const {
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, center);
     model = glm::scale(model, glm::vec3(width, height, depth));
-    setModelAndDraw(shader, box, model);
+    drawMesh(renderer, box, model, color);
+}
+
+void Building::addBox(std::vector<StaticBox>& out, int chunk, glm::vec3 color,
+    glm::vec3 center, float width, float height, float depth) const {
+    StaticBox b;
+    b.chunk = chunk;
+    b.center = center;
+    b.size = glm::vec3(width, height, depth);
+    b.color = color;
+    out.push_back(b);
 }
 
-void Building::DrawFloors(unsigned int shader, const Mesh& quad, const Mesh& box) const {
+void Building::BuildStaticGeometry() {
+    std::vector<StaticBox> boxes;
+    collectFloors(boxes);
+    collectShaft(boxes);
+
+    // Group boxes by chunk (one per floor, then the full-height shaft walls)
+    // so each chunk is a contiguous index range that can be culled on its own
+    std::stable_sort(boxes.begin(), boxes.end(),
+        [](const StaticBox& a, const StaticBox& b) { return a.chunk < b.chunk; });
+    staticChunks.assign(NUM_FLOORS + 1, StaticChunk());
+
+    // Face normal and the two in-plane axes (u x v = normal), same face order as createBoxMesh
+    static const glm::vec3 faces[6][3] = {
+        { glm::vec3( 0, 0, 1), glm::vec3( 1, 0, 0), glm::vec3(0, 1, 0) },
+        { glm::vec3( 0, 0,-1), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0) },
+        { glm::vec3( 0, 1, 0), glm::vec3( 1, 0, 0), glm::vec3(0, 0,-1) },
+        { glm::vec3( 0,-1, 0), glm::vec3( 1, 0, 0), glm::vec3(0, 0, 1) },
+        { glm::vec3( 1, 0, 0), glm::vec3( 0, 0,-1), glm::vec3(0, 1, 0) },
+        { glm::vec3(-1, 0, 0), glm::vec3( 0, 0, 1), glm::vec3(0, 1, 0) },
+    };
+    static const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+
+    // position(3f) + normal(3f) + texcoord(2f) + color(3f), all in world space
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve(boxes.size() * 24 * 11);
+    indices.reserve(boxes.size() * 36);
+
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const StaticBox& b = boxes[i];
+        glm::vec3 half = b.size * 0.5f;
+
+        StaticChunk& chunk = staticChunks[b.chunk];
+        AABB box;
+        box.min = b.center - half;
+        box.max = b.center + half;
+        if (chunk.indexCount == 0) {
+            chunk.firstIndex = (int)indices.size();
+            chunk.bounds = box;
+        } else {
+            chunk.bounds = mergeAABB(chunk.bounds, box);
+        }
+        chunk.indexCount += 36;
+
+        for (int f = 0; f < 6; f++) {
+            const glm::vec3& n = faces[f][0];
+            unsigned int base = (unsigned int)(vertices.size() / 11);
+            for (int c = 0; c < 4; c++) {
+                glm::vec3 p = b.center + half * (n + corners[c][0] * faces[f][1] + corners[c][1] * faces[f][2]);
+                float u = corners[c][0] * 0.5f + 0.5f;
+                float v = corners[c][1] * 0.5f + 0.5f;
+                vertices.insert(vertices.end(), { p.x, p.y, p.z,  n.x, n.y, n.z,  u, v,  b.color.r, b.color.g, b.color.b });
+            }
+            indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+        }
+    }
+
+    staticIndexCount = (int)indices.size();
+
+    glGenVertexArrays(1, &staticVAO);
+    glGenBuffers(1, &staticVBO);
+    glGenBuffers(1, &staticEBO);
+
+    stateBindVertexArray(staticVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, staticVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, staticEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    // per-vertex colour (location 3)
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(8 * sizeof(float)));
+    glEnableVertexAttribArray(3);
+
+    stateBindVertexArray(0);
+}
+
+void Building::DestroyStaticGeometry() {
+    glDeleteVertexArrays(1, &staticVAO);
+    glDeleteBuffers(1, &staticVBO);
+    glDeleteBuffers(1, &staticEBO);
+    staticVAO = staticVBO = staticEBO = 0;
+    staticIndexCount = 0;
+    staticChunks.clear();
+}
+
+// Floors, walls and the shaft from the baked buffer - vertices are already in world space.
+// Only chunks in the visible set are considered, so the cost does not grow with NUM_FLOORS;
+// chunks outside the frustum are skipped and adjacent visible chunks merge into one range.
+void Building::DrawStatic(InstanceRenderer& renderer, const VisibleSet& visible) const {
+    if (staticChunks.empty()) return;
+
+    int rangeFirst = -1, rangeCount = 0;
+    AABB rangeBounds;
+    for (int i = visible.firstFloor; i <= visible.lastFloor + 1; i++) {
+        // One past the floor range stands for the shaft chunk
+        int c = (i <= visible.lastFloor) ? i : NUM_FLOORS;
+        if (c == NUM_FLOORS && !visible.shaft) break;
+
+        const StaticChunk& chunk = staticChunks[c];
+        if (chunk.indexCount == 0 || !renderer.IsVisible(chunk.bounds)) continue;
+
+        if (rangeFirst >= 0 && rangeFirst + rangeCount == chunk.firstIndex) {
+            rangeCount += chunk.indexCount;
+            rangeBounds = mergeAABB(rangeBounds, chunk.bounds);
+            continue;
+        }
+        if (rangeFirst >= 0)
+            renderer.PushVertexColored(staticVAO, rangeFirst, rangeCount, glm::mat4(1.0f), rangeBounds);
+        rangeFirst = chunk.firstIndex;
+        rangeCount = chunk.indexCount;
+        rangeBounds = chunk.bounds;
+    }
+    if (rangeFirst >= 0)
+        renderer.PushVertexColored(staticVAO, rangeFirst, rangeCount, glm::mat4(1.0f), rangeBounds);
+}
+
+void Building::collectFloors(std::vector<StaticBox>& out) const {
+    glm::vec3 color;
     float halfW = BUILDING_WIDTH / 2.0f;
     float elevHalfW = ELEVATOR_WIDTH / 2.0f;
     float elevHalfD = ELEVATOR_DEPTH / 2.0f;
     float elevFrontZ = SHAFT_CENTER_Z + elevHalfD;
     float elevBackZ = SHAFT_CENTER_Z - elevHalfD;
 
+    // X ranges no shaft occupies: left of the bank, the gaps between
+    // neighbouring shafts and right of the bank (x = start, y = end)
+    std::vector<glm::vec2> openSpans;
+    float spanStart = -halfW;
+    for (int c = 0; c < NUM_CARS; c++) {
+        float shaftLeft = carShaftX(c) - elevHalfW;
+        if (shaftLeft - spanStart > 0.01f)
+            openSpans.push_back(glm::vec2(spanStart, shaftLeft));
+        spanStart = carShaftX(c) + elevHalfW;
+    }
+    if (halfW - spanStart > 0.01f)
+        openSpans.push_back(glm::vec2(spanStart, halfW));
+
+    // Hallway in front of the shafts: from z = elevFrontZ to z = 0
+    float hallFrontD = -elevFrontZ;
+    float hallFrontCZ = elevFrontZ / 2.0f;
+    // Behind the shafts: from z = -BUILDING_DEPTH to z = elevBackZ
+    float behindShaftD = elevBackZ - (-BUILDING_DEPTH);
+    float hallBackCZ = ((-BUILDING_DEPTH) + elevBackZ) / 2.0f;
+
     for (int i = 0; i < NUM_FLOORS; i++) {
         float baseY = i * FLOOR_HEIGHT;
         float midY = baseY + FLOOR_HEIGHT / 2.0f;
 
-        // Floor slab - split around elevator shaft to avoid clipping
-        // The shaft occupies X: [SHAFT_CENTER_X - elevHalfW, SHAFT_CENTER_X + elevHalfW]
-        //                   Z: [SHAFT_CENTER_Z - elevHalfD, SHAFT_CENTER_Z + elevHalfD]
-        setMaterial(shader, glm::vec3(0.45f, 0.4f, 0.35f));
-
-        // Floor: left of shaft
-        float leftFloorW = (halfW + (SHAFT_CENTER_X - elevHalfW));
-        if (leftFloorW > 0.01f) {
-            float cx = (-halfW + SHAFT_CENTER_X - elevHalfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(cx, baseY - 0.05f, -BUILDING_DEPTH / 2.0f),
-                leftFloorW, 0.1f, BUILDING_DEPTH);
-        }
-
-        // Floor: right of shaft
-        float rightFloorW = (halfW - (SHAFT_CENTER_X + elevHalfW));
-        if (rightFloorW > 0.01f) {
-            float cx = (SHAFT_CENTER_X + elevHalfW + halfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(cx, baseY - 0.05f, -BUILDING_DEPTH / 2.0f),
-                rightFloorW, 0.1f, BUILDING_DEPTH);
+        // Floor slab - split around the elevator shafts to avoid clipping:
+        // full depth over the open spans, in front of and behind each shaft
+        color = glm::vec3(0.45f, 0.4f, 0.35f);
+        for (const glm::vec2& span : openSpans) {
+            addBox(out, i, color,
+                glm::vec3((span.x + span.y) / 2.0f, baseY - 0.05f, -BUILDING_DEPTH / 2.0f),
+                span.y - span.x, 0.1f, BUILDING_DEPTH);
         }
-
-        // Floor: in front of shaft (between shaft front and building front)
-        float frontFloorD = BUILDING_DEPTH - (BUILDING_DEPTH + (SHAFT_CENTER_Z - elevHalfD));
-        // Actually: from z=0 to z=elevFrontZ is in front
-        float frontZ_start = 0.0f;
-        float frontZ_end = elevFrontZ;
-        float frontDepth = frontZ_start - frontZ_end; // this would be negative; let's use proper coords
-        // Hallway floor: from z = -BUILDING_DEPTH to z = elevBackZ (behind shaft) - skip
-        // Hallway floor: from z = elevFrontZ to z = 0 (in front of shaft)
-        float hallFrontD = -elevFrontZ; // distance from elevFrontZ to z=0
-        if (hallFrontD > 0.01f) {
-            float hallFrontCZ = (elevFrontZ + 0.0f) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY - 0.05f, hallFrontCZ),
-                ELEVATOR_WIDTH, 0.1f, hallFrontD);
-        }
-
-        // Floor: behind shaft (from z = -BUILDING_DEPTH to z = elevBackZ)
-        float hallBackD = (-elevBackZ) - BUILDING_DEPTH; // should be positive
-        float behindShaftD = elevBackZ - (-BUILDING_DEPTH);
-        if (behindShaftD > 0.01f) {
-            float hallBackCZ = ((-BUILDING_DEPTH) + elevBackZ) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY - 0.05f, hallBackCZ),
-                ELEVATOR_WIDTH, 0.1f, behindShaftD);
+        for (int c = 0; c < NUM_CARS; c++) {
+            if (hallFrontD > 0.01f) {
+                addBox(out, i, color,
+                    glm::vec3(carShaftX(c), baseY - 0.05f, hallFrontCZ),
+                    ELEVATOR_WIDTH, 0.1f, hallFrontD);
+            }
+            if (behindShaftD > 0.01f) {
+                addBox(out, i, color,
+                    glm::vec3(carShaftX(c), baseY - 0.05f, hallBackCZ),
+                    ELEVATOR_WIDTH, 0.1f, behindShaftD);
+            }
         }
 
         // Ceiling - same split pattern
-        setMaterial(shader, glm::vec3(0.85f, 0.85f, 0.82f));
-
-        // Ceiling: left of shaft
-        if (leftFloorW > 0.01f) {
-            float cx = (-halfW + SHAFT_CENTER_X - elevHalfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(cx, baseY + FLOOR_HEIGHT - 0.025f, -BUILDING_DEPTH / 2.0f),
-                leftFloorW, 0.05f, BUILDING_DEPTH);
-        }
-
-        // Ceiling: right of shaft
-        if (rightFloorW > 0.01f) {
-            float cx = (SHAFT_CENTER_X + elevHalfW + halfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(cx, baseY + FLOOR_HEIGHT - 0.025f, -BUILDING_DEPTH / 2.0f),
-                rightFloorW, 0.05f, BUILDING_DEPTH);
-        }
-
-        // Ceiling: in front of shaft
-        if (hallFrontD > 0.01f) {
-            float hallFrontCZ = (elevFrontZ + 0.0f) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY + FLOOR_HEIGHT - 0.025f, hallFrontCZ),
-                ELEVATOR_WIDTH, 0.05f, hallFrontD);
+        color = glm::vec3(0.85f, 0.85f, 0.82f);
+        for (const glm::vec2& span : openSpans) {
+            addBox(out, i, color,
+                glm::vec3((span.x + span.y) / 2.0f, baseY + FLOOR_HEIGHT - 0.025f, -BUILDING_DEPTH / 2.0f),
+                span.y - span.x, 0.05f, BUILDING_DEPTH);
         }
-
-        // Ceiling: behind shaft
-        if (behindShaftD > 0.01f) {
-            float hallBackCZ = ((-BUILDING_DEPTH) + elevBackZ) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY + FLOOR_HEIGHT - 0.025f, hallBackCZ),
-                ELEVATOR_WIDTH, 0.05f, behindShaftD);
+        for (int c = 0; c < NUM_CARS; c++) {
+            if (hallFrontD > 0.01f) {
+                addBox(out, i, color,
+                    glm::vec3(carShaftX(c), baseY + FLOOR_HEIGHT - 0.025f, hallFrontCZ),
+                    ELEVATOR_WIDTH, 0.05f, hallFrontD);
+            }
+            if (behindShaftD > 0.01f) {
+                addBox(out, i, color,
+                    glm::vec3(carShaftX(c), baseY + FLOOR_HEIGHT - 0.025f, hallBackCZ),
+                    ELEVATOR_WIDTH, 0.05f, behindShaftD);
+            }
         }
 
         // Back wall (z = -BUILDING_DEPTH) - thin box
-        setMaterial(shader, glm::vec3(0.75f, 0.72f, 0.68f));
-        drawWall(shader, box,
+        color = glm::vec3(0.75f, 0.72f, 0.68f);
+        addBox(out, i, color,
             glm::vec3(0.0f, midY, -BUILDING_DEPTH),
             BUILDING_WIDTH, FLOOR_HEIGHT, WALL_THICKNESS);
 
         // Front wall (z = 0) - closes the building from the front
-        setMaterial(shader, glm::vec3(0.73f, 0.7f, 0.66f));
-        drawWall(shader, box,
+        color = glm::vec3(0.73f, 0.7f, 0.66f);
+        addBox(out, i, color,
             glm::vec3(0.0f, midY, 0.0f),
             BUILDING_WIDTH, FLOOR_HEIGHT, WALL_THICKNESS);
 
         // Left wall (x = -halfW)
-        setMaterial(shader, glm::vec3(0.72f, 0.68f, 0.62f));
-        drawWall(shader, box,
+        color = glm::vec3(0.72f, 0.68f, 0.62f);
+        addBox(out, i, color,
             glm::vec3(-halfW, midY, -BUILDING_DEPTH / 2.0f),
             WALL_THICKNESS, FLOOR_HEIGHT, BUILDING_DEPTH);
 
         // Right wall (x = +halfW)
-        setMaterial(shader, glm::vec3(0.72f, 0.68f, 0.62f));
-        drawWall(shader, box,
+        color = glm::vec3(0.72f, 0.68f, 0.62f);
+        addBox(out, i, color,
             glm::vec3(halfW, midY, -BUILDING_DEPTH / 2.0f),
             WALL_THICKNESS, FLOOR_HEIGHT, BUILDING_DEPTH);
 
-        // Front wall with elevator opening - the wall at z=0 that separates
-        // the hallway from the elevator shaft
-        // We draw the wall around the elevator opening
-        setMaterial(shader, glm::vec3(0.7f, 0.7f, 0.65f));
-
-        // Wall segment between elevator front and z=0 (the approach wall)
-        // This is the wall where the elevator door opening is
+        // Approach wall at the shaft fronts, separating the hallway from the
+        // shafts: full height over the open spans, and above each door opening
+        color = glm::vec3(0.7f, 0.7f, 0.65f);
         float wallZ = elevFrontZ;
 
-        // Left of elevator opening
-        float leftWallW = (halfW + (SHAFT_CENTER_X - elevHalfW));
-        if (leftWallW > 0.01f) {
-            float centerX = (-halfW + SHAFT_CENTER_X - elevHalfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(centerX, midY, wallZ),
-                leftWallW, FLOOR_HEIGHT, WALL_THICKNESS);
-        }
-
-        // Right of elevator opening
-        float rightWallW = (halfW - (SHAFT_CENTER_X + elevHalfW));
-        if (rightWallW > 0.01f) {
-            float centerX = (SHAFT_CENTER_X + elevHalfW + halfW) / 2.0f;
-            drawWall(shader, box,
-                glm::vec3(centerX, midY, wallZ),
-                rightWallW, FLOOR_HEIGHT, WALL_THICKNESS);
+        for (const glm::vec2& span : openSpans) {
+            addBox(out, i, color,
+                glm::vec3((span.x + span.y) / 2.0f, midY, wallZ),
+                span.y - span.x, FLOOR_HEIGHT, WALL_THICKNESS);
         }
 
-        // Above elevator door opening
         float aboveH = FLOOR_HEIGHT - DOOR_HEIGHT;
         if (aboveH > 0.01f) {
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY + DOOR_HEIGHT + aboveH / 2.0f, wallZ),
-                ELEVATOR_WIDTH, aboveH, WALL_THICKNESS);
+            for (int c = 0; c < NUM_CARS; c++) {
+                addBox(out, i, color,
+                    glm::vec3(carShaftX(c), baseY + DOOR_HEIGHT + aboveH / 2.0f, wallZ),
+                    ELEVATOR_WIDTH, aboveH, WALL_THICKNESS);
+            }
         }
     }
 }
 
-void Building::DrawElevatorShaft(unsigned int shader, const Mesh& box) const {
+void Building::collectShaft(std::vector<StaticBox>& out) const {
+    for (int c = 0; c < NUM_CARS; c++)
+        collectShaft(out, carShaftX(c));
+}
+
+void Building::collectShaft(std::vector<StaticBox>& out, float shaftX) const {
+    glm::vec3 color;
     float totalH = NUM_FLOORS * FLOOR_HEIGHT;
     float elevHalfW = ELEVATOR_WIDTH / 2.0f;
     float elevHalfD = ELEVATOR_DEPTH / 2.0f;
     float elevFrontZ = SHAFT_CENTER_Z + elevHalfD;
 
-    setMaterial(shader, glm::vec3(0.5f, 0.5f, 0.5f));
+    color = glm::vec3(0.5f, 0.5f, 0.5f);
 
     // Left shaft wall
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X - elevHalfW, totalH / 2.0f, SHAFT_CENTER_Z),
+    addBox(out, NUM_FLOORS, color,
+        glm::vec3(shaftX - elevHalfW, totalH / 2.0f, SHAFT_CENTER_Z),
         WALL_THICKNESS, totalH, ELEVATOR_DEPTH);
 
     // Right shaft wall
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X + elevHalfW, totalH / 2.0f, SHAFT_CENTER_Z),
+    addBox(out, NUM_FLOORS, color,
+        glm::vec3(shaftX + elevHalfW, totalH / 2.0f, SHAFT_CENTER_Z),
         WALL_THICKNESS, totalH, ELEVATOR_DEPTH);
 
     // Back shaft wall
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X, totalH / 2.0f, SHAFT_CENTER_Z - elevHalfD),
+    addBox(out, NUM_FLOORS, color,
+        glm::vec3(shaftX, totalH / 2.0f, SHAFT_CENTER_Z - elevHalfD),
         ELEVATOR_WIDTH, totalH, WALL_THICKNESS);
 
     // Front shaft wall - closes the shaft from the hallway side
     // Draw a full wall with door-sized openings on each floor
-    setMaterial(shader, glm::vec3(0.55f, 0.55f, 0.52f));
+    color = glm::vec3(0.55f, 0.55f, 0.52f);
     for (int i = 0; i < NUM_FLOORS; i++) {
         float baseY = i * FLOOR_HEIGHT;
 
         // Left of door opening
         float leftW = elevHalfW - DOOR_WIDTH;
         if (leftW > 0.01f) {
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X - DOOR_WIDTH - leftW / 2.0f,
+            addBox(out, i, color,
+                glm::vec3(shaftX - DOOR_WIDTH - leftW / 2.0f,
                            baseY + DOOR_HEIGHT / 2.0f, elevFrontZ),
                 leftW, DOOR_HEIGHT, WALL_THICKNESS);
         }
@@ -220,8 +326,8 @@ void Building::DrawElevatorShaft(unsigned int shader, const Mesh& box) const {
         // Right of door opening
         float rightW = elevHalfW - DOOR_WIDTH;
         if (rightW > 0.01f) {
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X + DOOR_WIDTH + rightW / 2.0f,
+            addBox(out, i, color,
+                glm::vec3(shaftX + DOOR_WIDTH + rightW / 2.0f,
                            baseY + DOOR_HEIGHT / 2.0f, elevFrontZ),
                 rightW, DOOR_HEIGHT, WALL_THICKNESS);
         }
@@ -229,127 +335,134 @@ void Building::DrawElevatorShaft(unsigned int shader, const Mesh& box) const {
         // Above door opening
         float aboveH = FLOOR_HEIGHT - DOOR_HEIGHT;
         if (aboveH > 0.01f) {
-            drawWall(shader, box,
-                glm::vec3(SHAFT_CENTER_X, baseY + DOOR_HEIGHT + aboveH / 2.0f, elevFrontZ),
+            addBox(out, i, color,
+                glm::vec3(shaftX, baseY + DOOR_HEIGHT + aboveH / 2.0f, elevFrontZ),
                 ELEVATOR_WIDTH, aboveH, WALL_THICKNESS);
         }
     }
 }
 
-void Building::DrawElevatorCab(unsigned int shader, float elevatorY, float doorOpenAmount,
+void Building::DrawElevatorCab(InstanceRenderer& renderer, int car, float elevatorY, float doorOpenAmount,
                                 const Mesh& box, const Mesh& quad) const {
+    glm::vec3 color;
+    float carX = carShaftX(car);
     float elevHalfW = ELEVATOR_WIDTH / 2.0f;
     float elevHalfD = ELEVATOR_DEPTH / 2.0f;
     float elevFrontZ = SHAFT_CENTER_Z + elevHalfD;
     float midY = elevatorY + ELEVATOR_HEIGHT / 2.0f;
 
     // Elevator floor
-    setMaterial(shader, glm::vec3(0.35f, 0.3f, 0.25f));
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X, elevatorY + 0.02f, SHAFT_CENTER_Z),
+    color = glm::vec3(0.35f, 0.3f, 0.25f);
+    drawWall(renderer, box, color,
+        glm::vec3(carX, elevatorY + 0.02f, SHAFT_CENTER_Z),
         ELEVATOR_WIDTH - 0.02f, 0.04f, ELEVATOR_DEPTH - 0.02f);
 
     // Elevator ceiling
-    setMaterial(shader, glm::vec3(0.82f, 0.82f, 0.78f));
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X, elevatorY + ELEVATOR_HEIGHT - 0.02f, SHAFT_CENTER_Z),
+    color = glm::vec3(0.82f, 0.82f, 0.78f);
+    drawWall(renderer, box, color,
+        glm::vec3(carX, elevatorY + ELEVATOR_HEIGHT - 0.02f, SHAFT_CENTER_Z),
         ELEVATOR_WIDTH - 0.02f, 0.04f, ELEVATOR_DEPTH - 0.02f);
 
     // Elevator back wall (inside)
-    setMaterial(shader, glm::vec3(0.6f, 0.58f, 0.55f));
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X, midY, SHAFT_CENTER_Z - elevHalfD + 0.05f),
+    color = glm::vec3(0.6f, 0.58f, 0.55f);
+    drawWall(renderer, box, color,
+        glm::vec3(carX, midY, SHAFT_CENTER_Z - elevHalfD + 0.05f),
         ELEVATOR_WIDTH - 0.04f, ELEVATOR_HEIGHT - 0.04f, 0.05f);
 
     // Elevator left wall (inside)
-    setMaterial(shader, glm::vec3(0.62f, 0.6f, 0.57f));
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X - elevHalfW + 0.05f, midY, SHAFT_CENTER_Z),
+    color = glm::vec3(0.62f, 0.6f, 0.57f);
+    drawWall(renderer, box, color,
+        glm::vec3(carX - elevHalfW + 0.05f, midY, SHAFT_CENTER_Z),
         0.05f, ELEVATOR_HEIGHT - 0.04f, ELEVATOR_DEPTH - 0.04f);
 
     // Elevator right wall (inside) - button panel goes here
-    setMaterial(shader, glm::vec3(0.62f, 0.6f, 0.57f));
-    drawWall(shader, box,
-        glm::vec3(SHAFT_CENTER_X + elevHalfW - 0.05f, midY, SHAFT_CENTER_Z),
+    color = glm::vec3(0.62f, 0.6f, 0.57f);
+    drawWall(renderer, box, color,
+        glm::vec3(carX + elevHalfW - 0.05f, midY, SHAFT_CENTER_Z),
         0.05f, ELEVATOR_HEIGHT - 0.04f, ELEVATOR_DEPTH - 0.04f);
 
     // Doors - two fixed-width panels that slide left/right into the walls
-    setMaterial(shader, glm::vec3(0.6f, 0.62f, 0.65f));
+    color = glm::vec3(0.6f, 0.62f, 0.65f);
     float doorSlide = doorOpenAmount * DOOR_WIDTH; // how far each door has slid
 
     // Left door panel - slides left (into left wall)
-    // When closed: centered at SHAFT_CENTER_X - DOOR_WIDTH/2
+    // When closed: centered at carX - DOOR_WIDTH/2
     // When open: slid left by doorSlide
     {
-        float leftDoorCenterX = SHAFT_CENTER_X - DOOR_WIDTH / 2.0f - doorSlide;
-        drawWall(shader, box,
+        float leftDoorCenterX = carX - DOOR_WIDTH / 2.0f - doorSlide;
+        drawWall(renderer, box, color,
             glm::vec3(leftDoorCenterX, elevatorY + DOOR_HEIGHT / 2.0f, elevFrontZ),
             DOOR_WIDTH, DOOR_HEIGHT, 0.06f);
     }
 
     // Right door panel - slides right (into right wall)
-    // When closed: centered at SHAFT_CENTER_X + DOOR_WIDTH/2
+    // When closed: centered at carX + DOOR_WIDTH/2
     // When open: slid right by doorSlide
     {
-        float rightDoorCenterX = SHAFT_CENTER_X + DOOR_WIDTH / 2.0f + doorSlide;
-        drawWall(shader, box,
+        float rightDoorCenterX = carX + DOOR_WIDTH / 2.0f + doorSlide;
+        drawWall(renderer, box, color,
             glm::vec3(rightDoorCenterX, elevatorY + DOOR_HEIGHT / 2.0f, elevFrontZ),
             DOOR_WIDTH, DOOR_HEIGHT, 0.06f);
     }
 }
 
-void Building::DrawLightFixtures(unsigned int shader, float elevatorY,
-                                  const Mesh& cylinder, const Mesh& sphere, const Mesh& cone) const {
-    for (int i = 0; i < NUM_FLOORS; i++) {
+void Building::DrawLightFixtures(InstanceRenderer& renderer, const VisibleSet& visible,
+                                  LodSelector& lod, const LodMesh& cylinder, const LodMesh& cone) const {
+    glm::vec3 color;
+    for (int i = visible.firstFloor; i <= visible.lastFloor; i++) {
         float baseY = i * FLOOR_HEIGHT;
         float fixtureY = baseY + FLOOR_HEIGHT - 0.05f;
         float lightZ = -BUILDING_DEPTH / 2.0f;
 
         // Mounting rod
-        setMaterial(shader, glm::vec3(0.3f, 0.3f, 0.3f));
+        color = glm::vec3(0.3f, 0.3f, 0.3f);
         {
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(0.0f, fixtureY - 0.1f, lightZ));
             model = glm::scale(model, glm::vec3(0.04f, 0.25f, 0.04f));
-            setModelAndDraw(shader, cylinder, model);
+            drawLod(renderer, lod, LOD_FIXTURE_FIRST + i * 2, cylinder, model, color);
         }
 
         // Shade (inverted cone)
-        setMaterial(shader, glm::vec3(0.9f, 0.85f, 0.7f));
+        color = glm::vec3(0.9f, 0.85f, 0.7f);
         {
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(0.0f, fixtureY - 0.3f, lightZ));
             model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
             model = glm::scale(model, glm::vec3(0.3f, 0.18f, 0.3f));
-            setModelAndDraw(shader, cone, model);
+            drawLod(renderer, lod, LOD_FIXTURE_FIRST + i * 2 + 1, cone, model, color);
         }
     }
+}
 
-    // Elevator light fixture
-    {
-        float fixtureY = elevatorY + ELEVATOR_HEIGHT - 0.05f;
+void Building::DrawCabFixture(InstanceRenderer& renderer, int car, float elevatorY,
+                              LodSelector& lod, const LodMesh& cylinder, const LodMesh& cone) const {
+    glm::vec3 color;
+    float carX = carShaftX(car);
+    float fixtureY = elevatorY + ELEVATOR_HEIGHT - 0.05f;
+    int lodId = LOD_CAB_FIXTURE_FIRST + car * 2;
 
-        setMaterial(shader, glm::vec3(0.3f, 0.3f, 0.3f));
-        {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(SHAFT_CENTER_X, fixtureY - 0.08f, SHAFT_CENTER_Z));
-            model = glm::scale(model, glm::vec3(0.03f, 0.18f, 0.03f));
-            setModelAndDraw(shader, cylinder, model);
-        }
+    color = glm::vec3(0.3f, 0.3f, 0.3f);
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(carX, fixtureY - 0.08f, SHAFT_CENTER_Z));
+        model = glm::scale(model, glm::vec3(0.03f, 0.18f, 0.03f));
+        drawLod(renderer, lod, lodId, cylinder, model, color);
+    }
 
-        setMaterial(shader, glm::vec3(0.9f, 0.85f, 0.7f));
-        {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(SHAFT_CENTER_X, fixtureY - 0.22f, SHAFT_CENTER_Z));
-            model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(0.22f, 0.14f, 0.22f));
-            setModelAndDraw(shader, cone, model);
-        }
+    color = glm::vec3(0.9f, 0.85f, 0.7f);
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(carX, fixtureY - 0.22f, SHAFT_CENTER_Z));
+        model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(0.22f, 0.14f, 0.22f));
+        drawLod(renderer, lod, lodId + 1, cone, model, color);
     }
 }
 
-void Building::DrawPlants(unsigned int shader,
-                           const Mesh& cylinder, const Mesh& sphere, const Mesh& cone) const {
+void Building::DrawPlants(InstanceRenderer& renderer, const VisibleSet& visible, LodSelector& lod,
+                           const LodMesh& cylinder, const LodMesh& sphere, const LodMesh& cone) const {
+    glm::vec3 color;
     struct PlantInfo {
         int floor;
         int type;
@@ -367,11 +480,15 @@ void Building::DrawPlants(unsigned int shader,
         {7, 1, glm::vec3(-4.0f, 0.0f, -5.5f)},
     };
 
-    for (const auto& p : plants) {
+    for (int n = 0; n < (int)(sizeof(plants) / sizeof(plants[0])); n++) {
+        const PlantInfo& p = plants[n];
+        if (p.floor < visible.firstFloor || p.floor > visible.lastFloor) continue;
+        int lodId = LOD_PLANT_FIRST + n * 3;
+
         float baseY = p.floor * FLOOR_HEIGHT;
         glm::vec3 potPos = p.pos + glm::vec3(0.0f, baseY, 0.0f);
 
-        setMaterial(shader, glm::vec3(0.55f, 0.32f, 0.15f));
+        color = glm::vec3(0.55f, 0.32f, 0.15f);
 
         if (p.type == 0) {
             // Type A: tall conical
@@ -379,14 +496,14 @@ void Building::DrawPlants(unsigned int shader,
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.2f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.32f, 0.4f, 0.32f));
-                setModelAndDraw(shader, cylinder, model);
+                drawLod(renderer, lod, lodId, cylinder, model, color);
             }
-            setMaterial(shader, glm::vec3(0.1f, 0.5f, 0.15f));
+            color = glm::vec3(0.1f, 0.5f, 0.15f);
             {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.95f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.55f, 1.1f, 0.55f));
-                setModelAndDraw(shader, cone, model);
+                drawLod(renderer, lod, lodId + 1, cone, model, color);
             }
         } else if (p.type == 1) {
             // Type B: round bush
@@ -394,14 +511,14 @@ void Building::DrawPlants(unsigned int shader,
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.15f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.28f, 0.3f, 0.28f));
-                setModelAndDraw(shader, cylinder, model);
+                drawLod(renderer, lod, lodId, cylinder, model, color);
             }
-            setMaterial(shader, glm::vec3(0.12f, 0.55f, 0.1f));
+            color = glm::vec3(0.12f, 0.55f, 0.1f);
             {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.85f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.65f, 0.65f, 0.65f));
-                setModelAndDraw(shader, sphere, model);
+                drawLod(renderer, lod, lodId + 1, sphere, model, color);
             }
         } else {
             // Type C: wide flat
@@ -409,28 +526,28 @@ void Building::DrawPlants(unsigned int shader,
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.18f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.38f, 0.36f, 0.38f));
-                setModelAndDraw(shader, cylinder, model);
+                drawLod(renderer, lod, lodId, cylinder, model, color);
             }
-            setMaterial(shader, glm::vec3(0.18f, 0.58f, 0.18f));
+            color = glm::vec3(0.18f, 0.58f, 0.18f);
             {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.48f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.75f, 0.16f, 0.75f));
-                setModelAndDraw(shader, cylinder, model);
+                drawLod(renderer, lod, lodId + 1, cylinder, model, color);
             }
-            setMaterial(shader, glm::vec3(0.14f, 0.48f, 0.1f));
+            color = glm::vec3(0.14f, 0.48f, 0.1f);
             {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, potPos + glm::vec3(0.0f, 0.7f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.32f, 0.32f, 0.32f));
-                setModelAndDraw(shader, cone, model);
+                drawLod(renderer, lod, lodId + 2, cone, model, color);
             }
         }
     }
 }
 
 // Draw floor number display above each elevator opening
-void Building::DrawFloorNumbers(unsigned int shader, const Mesh& box, unsigned int* floorTextures) const {
+void Building::DrawFloorNumbers(InstanceRenderer& renderer, const Mesh& box, unsigned int floorTextureArray) const {
     // We'll draw colored indicators next to elevator doors on each floor
     // This is handled via texture in Main.cpp
 }
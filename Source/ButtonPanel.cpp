@@ -1,6 +1,5 @@
 #include "../Header/ButtonPanel.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <cmath>
 
 void ButtonPanel::Init() {
@@ -59,6 +58,7 @@ void ButtonPanel::Init() {
     // Close doors
     {
         Button3D btn;
+        btn.center = glm::vec3(0.0f); // updated in UpdatePositions
         btn.normal = normal;
         btn.halfW = btnSize / 2.0f;
         btn.halfH = btnSize / 2.0f;
@@ -75,6 +75,7 @@ void ButtonPanel::Init() {
     // Open doors
     {
         Button3D btn;
+        btn.center = glm::vec3(0.0f); // updated in UpdatePositions
         btn.normal = normal;
         btn.halfW = btnSize / 2.0f;
         btn.halfH = btnSize / 2.0f;
@@ -91,6 +92,7 @@ void ButtonPanel::Init() {
     // Stop
     {
         Button3D btn;
+        btn.center = glm::vec3(0.0f); // updated in UpdatePositions
         btn.normal = normal;
         btn.halfW = btnSize / 2.0f;
         btn.halfH = btnSize / 2.0f;
@@ -107,6 +109,7 @@ void ButtonPanel::Init() {
     // Ventilation
     {
         Button3D btn;
+        btn.center = glm::vec3(0.0f); // updated in UpdatePositions
         btn.normal = normal;
         btn.halfW = btnSize / 2.0f;
         btn.halfH = btnSize / 2.0f;
@@ -121,10 +124,10 @@ void ButtonPanel::Init() {
     }
 }
 
-void ButtonPanel::UpdatePositions(float elevatorY) {
+void ButtonPanel::UpdatePositions(float carX, float elevatorY) {
     for (size_t i = 0; i < buttons.size() && i < offsets.size(); i++) {
         buttons[i].center = glm::vec3(
-            SHAFT_CENTER_X + offsets[i].dx,
+            carX + offsets[i].dx,
             elevatorY + offsets[i].dy,
             SHAFT_CENTER_Z + offsets[i].dz
         );
@@ -164,59 +167,31 @@ int ButtonPanel::Raycast(glm::vec3 rayOrigin, glm::vec3 rayDir, float maxDist) c
     return closest;
 }
 
-void ButtonPanel::Draw(unsigned int shader, const Mesh& box, unsigned int* btnTextures) const {
+void ButtonPanel::Draw(InstanceRenderer& renderer, const Mesh& box, unsigned int btnTextureArray) const {
+    // No face culling for buttons so they're always visible
+    renderer.SetPass(PASS_DOUBLE_SIDED);
+
     for (size_t i = 0; i < buttons.size(); i++) {
         const Button3D& btn = buttons[i];
         glm::vec3 color = btn.active ? btn.activeColor : btn.inactiveColor;
 
-        // Determine which texture index this button uses
+        // Determine which array layer this button uses
         // Buttons 0-7: floor buttons (btn_0..btn_7)
         // Button 8: close doors (btn_8)
         // Button 9: open doors (btn_9)
         // Button 10: stop (btn_10)
         // Button 11: ventilation (btn_11)
-        int texIdx = (int)i; // buttons are stored in order: 8 floor + 4 control
-        bool hasTex = (btnTextures != nullptr && texIdx >= 0 && texIdx < 12 && btnTextures[texIdx] != 0);
-
-        if (hasTex) {
-            // Draw textured button with color tint
-            glUniform1i(glGetUniformLocation(shader, "useTexture"), 1);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, btnTextures[texIdx]);
-            glUniform1i(glGetUniformLocation(shader, "diffuseTexture"), 0);
-        } else {
-            glUniform3fv(glGetUniformLocation(shader, "solidColor"), 1, glm::value_ptr(color));
-            glUniform1i(glGetUniformLocation(shader, "useTexture"), 0);
-        }
+        int layer = (int)i; // buttons are stored in order: 8 floor + 4 control
 
         // Emissive for active buttons
-        if (btn.active) {
-            glUniform3fv(glGetUniformLocation(shader, "emissiveColor"), 1, glm::value_ptr(btn.activeColor));
-            glUniform1f(glGetUniformLocation(shader, "emissiveStrength"), 0.8f);
-        } else {
-            glm::vec3 zero(0.0f);
-            glUniform3fv(glGetUniformLocation(shader, "emissiveColor"), 1, glm::value_ptr(zero));
-            glUniform1f(glGetUniformLocation(shader, "emissiveStrength"), 0.0f);
-        }
+        glm::vec4 emissive = btn.active ? glm::vec4(btn.activeColor, 0.8f) : glm::vec4(0.0f);
 
         // Draw button as a small box protruding from the wall
-        // Disable face culling for buttons so they're always visible
-        glDisable(GL_CULL_FACE);
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, btn.center);
         model = glm::scale(model, glm::vec3(0.04f, btn.halfH * 2.0f, btn.halfW * 2.0f));
 
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glBindVertexArray(box.VAO);
-        glDrawElements(GL_TRIANGLES, box.indexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        glEnable(GL_CULL_FACE);
+        renderer.PushLayer(box, model, color, emissive, btnTextureArray, layer);
     }
-
-    // Reset emissive and texture state
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUniform1i(glGetUniformLocation(shader, "useTexture"), 0);
-    glm::vec3 zero(0.0f);
-    glUniform3fv(glGetUniformLocation(shader, "emissiveColor"), 1, glm::value_ptr(zero));
-    glUniform1f(glGetUniformLocation(shader, "emissiveStrength"), 0.0f);
+    renderer.SetPass(PASS_OPAQUE);
 }
@@ -1,13 +1,21 @@
 #include "../Header/Elevator.h"
 #include <cmath>
 
+// Fraction of one step within which a door, timer or floor counts as reached. Targets
+// that fall exactly on a step boundary then resolve the same way however the float
+// rounding went, which lets StepsToNextEvent predict the step Update acts in.
+static const float STEP_SLACK = 0.05f;
+// Doors count as open (AreDoorsOpen) once opened past this
+static const float DOORS_OPEN_AMOUNT = 0.01f;
+
 Elevator::Elevator()
     : currentFloor(1), targetFloor(-1), moving(false), stopped(false),
       doorOpenAmount(0.0f), doorOpen(false), doorTimer(0.0f),
       doorExtended(false), waitingForDoors(false),
       ventilationOn(false), ventilationColorActive(false),
       firstTargetFloor(-1),
-      floorRequests(NUM_FLOORS, false)
+      floorRequests(NUM_FLOORS, false), direction(0),
+      scheduler(getScheduler(SCHEDULE_LOOK))
 {
     currentY = GetFloorY(currentFloor);
 }
@@ -17,18 +25,42 @@ float Elevator::GetFloorY(int floor) const {
 }
 
 bool Elevator::AreDoorsOpen() const {
-    return doorOpenAmount > 0.01f;
+    return doorOpenAmount > DOORS_OPEN_AMOUNT;
 }
 
 bool Elevator::IsAtFloor(int floor) const {
     return !moving && currentFloor == floor;
 }
 
-int Elevator::findNextFloor() const {
-    for (int i = 0; i < NUM_FLOORS; i++) {
-        if (floorRequests[i]) return i;
+void Elevator::SetScheduler(SchedulingPolicy policy) {
+    scheduler = getScheduler(policy);
+}
+
+int Elevator::findNextFloor() {
+    return scheduler->NextFloor(floorRequests, currentY / FLOOR_HEIGHT, direction);
+}
+
+// Starts an idle cab with closed doors on its way to floor
+void Elevator::startTowards(int floor) {
+    targetFloor = floor;
+    firstTargetFloor = floor;
+    moving = true;
+    waitingForDoors = false;
+}
+
+// A request came in while moving: stop on the way if the scheduler picks a floor
+// between the cab and its target (never turns around mid-shaft)
+void Elevator::retarget() {
+    int heading = direction;
+    int next = scheduler->NextFloor(floorRequests, currentY / FLOOR_HEIGHT, heading);
+    if (next < 0 || next == targetFloor) return;
+
+    float travel = GetFloorY(targetFloor) - currentY;
+    float toNext = GetFloorY(next) - currentY;
+    if (toNext * travel > 0.0f && fabs(toNext) < fabs(travel)) {
+        targetFloor = next;
+        direction = heading;
     }
-    return -1;
 }
 
 void Elevator::Update(float deltaTime) {
@@ -39,13 +71,13 @@ void Elevator::Update(float deltaTime) {
             doorOpenAmount += DOOR_SPEED * deltaTime;
             if (doorOpenAmount > 1.0f) doorOpenAmount = 1.0f;
         }
-        if (doorTimer <= 0.0f) {
+        if (doorTimer <= STEP_SLACK * deltaTime) {
             doorOpen = false;
         }
     } else {
         if (doorOpenAmount > 0.0f) {
             doorOpenAmount -= DOOR_SPEED * deltaTime;
-            if (doorOpenAmount < 0.0f) doorOpenAmount = 0.0f;
+            if (doorOpenAmount <= STEP_SLACK * DOOR_SPEED * deltaTime) doorOpenAmount = 0.0f;
         }
         if (doorOpenAmount <= 0.0f && waitingForDoors) {
             waitingForDoors = false;
@@ -66,21 +98,33 @@ void Elevator::Update(float deltaTime) {
         float diff = targetY - currentY;
         float step = ELEVATOR_SPEED * deltaTime;
 
-        if (fabs(diff) <= step) {
+        if (fabs(diff) <= step * (1.0f + STEP_SLACK)) {
             currentY = targetY;
             currentFloor = targetFloor;
             moving = false;
-            floorRequests[currentFloor] = false;
 
-            // Arrived: open doors
-            doorOpen = true;
-            doorTimer = DOOR_OPEN_TIME;
-            doorExtended = false;
-            waitingForDoors = true;
-
-            // Ventilation color deactivation on first arrival
-            if (ventilationColorActive && currentFloor == firstTargetFloor) {
-                ventilationColorActive = false;
+            if (!floorRequests[currentFloor]) {
+                // Turnaround point nobody asked for (SCAN runs to the end of the
+                // shaft): carry on to the next request without a door cycle
+                targetFloor = -1;
+                int next = findNextFloor();
+                if (next >= 0) {
+                    targetFloor = next;
+                    moving = true;
+                }
+            } else {
+                floorRequests[currentFloor] = false;
+
+                // Arrived: open doors
+                doorOpen = true;
+                doorTimer = DOOR_OPEN_TIME;
+                doorExtended = false;
+                waitingForDoors = true;
+
+                // Ventilation color deactivation on first arrival
+                if (ventilationColorActive && currentFloor == firstTargetFloor) {
+                    ventilationColorActive = false;
+                }
             }
         } else {
             if (diff > 0) currentY += step;
@@ -89,6 +133,54 @@ void Elevator::Update(float deltaTime) {
     }
 }
 
+// Smallest n >= 1 with amount - n * step <= STEP_SLACK * step
+static long long stepsToUse(float amount, float step) {
+    long long n = (long long)ceil((double)amount / step - STEP_SLACK);
+    return n < 1 ? 1 : n;
+}
+
+long long Elevator::StepsToNextEvent(float dt) const {
+    long long next = -1;
+
+    if (doorOpen) {
+        next = stepsToUse(doorTimer, dt);
+        // Doors opening far enough to let people through
+        if (doorOpenAmount <= DOORS_OPEN_AMOUNT) {
+            long long opened = (long long)floor((double)(DOORS_OPEN_AMOUNT - doorOpenAmount) / (DOOR_SPEED * dt)) + 1;
+            if (opened < next) next = opened;
+        }
+    } else if (waitingForDoors) {
+        next = stepsToUse(doorOpenAmount, DOOR_SPEED * dt);
+    }
+
+    if (moving && !stopped) {
+        // Update arrives in the step that starts within one step of the floor
+        float distance = (float)fabs(GetFloorY(targetFloor) - currentY);
+        long long arrival = stepsToUse(distance, ELEVATOR_SPEED * dt);
+        if (next < 0 || arrival < next) next = arrival;
+    }
+    return next;
+}
+
+void Elevator::SkipSteps(long long steps, float dt) {
+    if (steps <= 0) return;
+    float span = (float)(steps * (double)dt);
+
+    if (doorOpen) {
+        doorTimer -= span;
+        doorOpenAmount = fmin(1.0f, doorOpenAmount + DOOR_SPEED * span);
+    } else if (doorOpenAmount > 0.0f) {
+        doorOpenAmount -= DOOR_SPEED * span;
+        if (doorOpenAmount <= STEP_SLACK * DOOR_SPEED * dt) doorOpenAmount = 0.0f;
+    }
+
+    if (moving && !stopped) {
+        float travel = ELEVATOR_SPEED * span;
+        if (GetFloorY(targetFloor) > currentY) currentY += travel;
+        else currentY -= travel;
+    }
+}
+
 void Elevator::RequestFloor(int floor) {
     if (floor < 0 || floor >= NUM_FLOORS) return;
     if (floor == currentFloor && !moving) return;
@@ -96,11 +188,10 @@ void Elevator::RequestFloor(int floor) {
     floorRequests[floor] = true;
 
     // Start moving if idle
-    if (!moving && doorOpenAmount <= 0.0f) {
-        targetFloor = floor;
-        firstTargetFloor = floor;
-        moving = true;
-        waitingForDoors = false;
+    if (moving) {
+        retarget();
+    } else if (doorOpenAmount <= 0.0f) {
+        startTowards(findNextFloor());
         if (ventilationOn) ventilationColorActive = true;
     } else if (!moving && (doorOpen || doorOpenAmount > 0.0f)) {
         // Doors are open/closing - close them first, then move
@@ -150,12 +241,11 @@ void Elevator::CallToFloor(int floor) {
     } else {
         // Request this floor
         floorRequests[floor] = true;
-        if (!moving && doorOpenAmount <= 0.0f) {
-            targetFloor = floor;
-            firstTargetFloor = floor;
-            moving = true;
-            waitingForDoors = false;
-        } else if (!moving) {
+        if (moving) {
+            retarget();
+        } else if (doorOpenAmount <= 0.0f) {
+            startTowards(findNextFloor());
+        } else {
             // Close doors first
             doorOpen = false;
             doorTimer = 0.0f;
@@ -0,0 +1,98 @@
+#include "../Header/ElevatorGroup.h"
+#include <cmath>
+
+// Time a stop adds: the doors open while DOOR_OPEN_TIME runs, then close
+static const float STOP_TIME = DOOR_OPEN_TIME + 1.0f / DOOR_SPEED;
+// Charge per stop a car already owes, whether or not it lies on the way
+static const float LOAD_WEIGHT = 2.0f;
+// A car on emergency stop only gets calls when every car is stopped
+static const float STOPPED_COST = 1.0e6f;
+
+ElevatorGroup::ElevatorGroup(int carCount)
+    : cars(carCount > 0 ? carCount : 1)
+{
+}
+
+void ElevatorGroup::SetScheduler(SchedulingPolicy policy) {
+    for (Elevator& car : cars)
+        car.SetScheduler(policy);
+}
+
+float ElevatorGroup::CallCost(int car, int floor) const {
+    const Elevator& e = cars[car];
+    if (e.stopped) return STOPPED_COST;
+    if (!e.moving && e.currentFloor == floor) return 0.0f; // opens right here
+
+    // Doors still open or closing finish their cycle before the car leaves
+    float wait = e.doorOpenAmount / DOOR_SPEED;
+    if (e.doorOpen && e.doorTimer > 0.0f) wait += e.doorTimer;
+
+    float position = e.currentY / FLOOR_HEIGHT;
+    int dir = e.direction;
+    if (e.moving) dir = e.GetFloorY(e.targetFloor) > e.currentY ? 1 : -1;
+
+    int pending = 0;
+    for (int f = 0; f < NUM_FLOORS; f++)
+        if (e.floorRequests[f]) pending++;
+
+    float travel;
+    int stops = 0;
+    if (dir == 0 || (floor - position) * dir >= 0.0f) {
+        // On the way: stops strictly between here and floor
+        travel = fabs(floor - position);
+        for (int f = 0; f < NUM_FLOORS; f++) {
+            if (e.floorRequests[f] && (f - position) * (floor - f) > 0.0f) stops++;
+        }
+    } else {
+        // Behind: out to the farthest stop ahead, then back past the ones in between
+        float farthest = position;
+        for (int f = 0; f < NUM_FLOORS; f++) {
+            if (!e.floorRequests[f]) continue;
+            if ((f - position) * dir > 0.0f) {
+                stops++;
+                if ((f - farthest) * dir > 0.0f) farthest = (float)f;
+            } else if ((position - f) * (f - floor) > 0.0f) {
+                stops++;
+            }
+        }
+        travel = fabs(farthest - position) + fabs(farthest - floor);
+    }
+
+    return wait + travel * FLOOR_HEIGHT / ELEVATOR_SPEED + stops * STOP_TIME + pending * LOAD_WEIGHT;
+}
+
+int ElevatorGroup::CallToFloor(int floor) {
+    if (floor < 0 || floor >= NUM_FLOORS) return -1;
+
+    int best = 0;
+    float bestCost = 0.0f;
+    for (int c = 0; c < (int)cars.size(); c++) {
+        // A car already stopping there takes the call for free
+        float cost = (cars[c].floorRequests[floor] && !cars[c].stopped) ? -1.0f : CallCost(c, floor);
+        if (c == 0 || cost < bestCost) {
+            best = c;
+            bestCost = cost;
+        }
+    }
+    cars[best].CallToFloor(floor);
+    return best;
+}
+
+void ElevatorGroup::Update(float deltaTime) {
+    for (Elevator& car : cars)
+        car.Update(deltaTime);
+}
+
+long long ElevatorGroup::StepsToNextEvent(float dt) const {
+    long long next = -1;
+    for (const Elevator& car : cars) {
+        long long steps = car.StepsToNextEvent(dt);
+        if (steps > 0 && (next < 0 || steps < next)) next = steps;
+    }
+    return next;
+}
+
+void ElevatorGroup::SkipSteps(long long steps, float dt) {
+    for (Elevator& car : cars)
+        car.SkipSteps(steps, dt);
+}
@@ -0,0 +1,38 @@
+#include "../Header/Frustum.h"
+
+void Frustum::Update(const glm::mat4& viewProjection) {
+    // Gribb/Hartmann: each plane is the 4th row of the matrix plus/minus one of the others.
+    // glm is column-major, so row r is (m[0][r], m[1][r], m[2][r], m[3][r]).
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0; // left
+    planes[1] = row3 - row0; // right
+    planes[2] = row3 + row1; // bottom
+    planes[3] = row3 - row1; // top
+    planes[4] = row3 + row2; // near
+    planes[5] = row3 - row2; // far
+
+    for (int i = 0; i < 6; i++) {
+        float len = glm::length(glm::vec3(planes[i]));
+        planes[i] /= len;
+    }
+}
+
+bool Frustum::IsVisible(const AABB& box) const {
+    for (int i = 0; i < 6; i++) {
+        const glm::vec4& p = planes[i];
+        // Corner of the box furthest along the plane normal
+        glm::vec3 v(
+            p.x >= 0.0f ? box.max.x : box.min.x,
+            p.y >= 0.0f ? box.max.y : box.min.y,
+            p.z >= 0.0f ? box.max.z : box.min.z
+        );
+        if (glm::dot(glm::vec3(p), v) + p.w < 0.0f)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+#include "../Header/GLState.h"
+
+static const unsigned int UNKNOWN = 0xFFFFFFFFu; // forces the next call through
+static const int MAX_UNITS = 16;
+static const GLenum TEXTURE_TARGETS[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER };
+static const int TARGET_COUNT = 3;
+static const GLenum CACHED_CAPS[] = { GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND };
+static const int CAP_COUNT = 3;
+
+static unsigned int boundProgram = UNKNOWN;
+static unsigned int boundVAO = UNKNOWN;
+static unsigned int activeUnit = UNKNOWN;
+static unsigned int boundTextures[MAX_UNITS][TARGET_COUNT];
+static int capStates[CAP_COUNT]; // 0 / 1, -1 unknown
+static unsigned int blendSrc = UNKNOWN, blendDst = UNKNOWN;
+static GLStateStats stats = { 0, 0 };
+static bool initialized = false;
+
+// Counts the call and says whether it has to reach GL
+static bool changes(unsigned int& cached, unsigned int value) {
+    if (cached == value) {
+        stats.filtered++;
+        return false;
+    }
+    cached = value;
+    stats.issued++;
+    return true;
+}
+
+static void ensureInitialized() {
+    if (!initialized) resetStateCache();
+}
+
+void resetStateCache() {
+    boundProgram = boundVAO = activeUnit = UNKNOWN;
+    for (int u = 0; u < MAX_UNITS; u++)
+        for (int t = 0; t < TARGET_COUNT; t++)
+            boundTextures[u][t] = UNKNOWN;
+    for (int c = 0; c < CAP_COUNT; c++)
+        capStates[c] = -1;
+    blendSrc = blendDst = UNKNOWN;
+    initialized = true;
+}
+
+void stateUseProgram(unsigned int program) {
+    ensureInitialized();
+    if (changes(boundProgram, program))
+        glUseProgram(program);
+}
+
+void stateBindVertexArray(unsigned int vao) {
+    ensureInitialized();
+    if (changes(boundVAO, vao))
+        glBindVertexArray(vao);
+}
+
+void stateBindTexture(int unit, GLenum target, unsigned int texture) {
+    ensureInitialized();
+    int t = 0;
+    while (t < TARGET_COUNT && TEXTURE_TARGETS[t] != target) t++;
+    if (t == TARGET_COUNT || unit < 0 || unit >= MAX_UNITS) {
+        // Not tracked: forward, selecting the unit through the cache
+        if (changes(activeUnit, (unsigned int)unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+        stats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (boundTextures[unit][t] == texture) {
+        stats.filtered++;
+        return;
+    }
+    if (changes(activeUnit, (unsigned int)unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+    changes(boundTextures[unit][t], texture);
+    glBindTexture(target, texture);
+}
+
+void stateSetEnabled(GLenum cap, bool enabled) {
+    ensureInitialized();
+    int c = 0;
+    while (c < CAP_COUNT && CACHED_CAPS[c] != cap) c++;
+    if (c < CAP_COUNT) {
+        if (capStates[c] == (enabled ? 1 : 0)) {
+            stats.filtered++;
+            return;
+        }
+        capStates[c] = enabled ? 1 : 0;
+    }
+    stats.issued++;
+    if (enabled) glEnable(cap);
+    else glDisable(cap);
+}
+
+bool stateIsEnabled(GLenum cap) {
+    ensureInitialized();
+    for (int c = 0; c < CAP_COUNT; c++) {
+        if (CACHED_CAPS[c] == cap && capStates[c] != -1)
+            return capStates[c] == 1;
+    }
+    return glIsEnabled(cap) == GL_TRUE;
+}
+
+void stateBlendFunc(GLenum src, GLenum dst) {
+    ensureInitialized();
+    if (blendSrc == src && blendDst == dst) {
+        stats.filtered++;
+        return;
+    }
+    blendSrc = src;
+    blendDst = dst;
+    stats.issued++;
+    glBlendFunc(src, dst);
+}
+
+void beginStateFrame() {
+    stats.issued = 0;
+    stats.filtered = 0;
+}
+
+const GLStateStats& getStateStats() {
+    return stats;
+}
@@ -0,0 +1,485 @@
+// Headless driver for the elevator control logic: replays a scripted call list
+// against a bank of cars (ElevatorGroup) as fast as the CPU allows, with no window or GL.
+//
+// Usage: elevator-headless [script] [--cars <n>] [--duration <sim seconds>] [--dt <step>]
+//                          [--events | --compare] [--policy lowest|look|scan|nearest]
+//                          [--benchmark [--seed <n>]]
+//                          [--traffic interfloor|up-peak|lunch|down-peak|day [--rate <n>] [--seed <n>]]
+//
+// By default every step runs Elevator::Update. --events jumps straight from one
+// state change to the next (Elevator::StepsToNextEvent) and should give the same
+// results up to float rounding; --compare runs both modes and prints the difference.
+//
+// Script lines are "<time> <command> [floor] [car]", times in simulated seconds
+// from the start of the script; '#' starts a comment. Commands:
+//   call <floor>           hall call, assigned to a car by the group
+//   request <floor> [car]  cab button press (RequestFloor) in car (default 0)
+//   open, close, stop, vent [car]
+// The script repeats until the duration is reached, each pass starting after the
+// last event plus one door cycle. Without a script a built-in day is used.
+//
+// Every call or request is timed until its floor is served (the cab stops there,
+// or it needed no trip); --benchmark generates a random request stream for the
+// duration (calls more frequent with more cars) and reports mean and p99 of that
+// latency for each scheduling policy.
+//
+// --traffic generates passengers (generateTraffic) at --rate per hour for the
+// duration and runs them through the bank with each policy, reporting how many
+// were delivered and their waiting and journey times, stepping from event to
+// event; with --compare it runs the --policy one with every step as well and
+// prints the difference.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Header/ElevatorGroup.h"
+#include "../Header/Traffic.h"
+#include "../Header/Constants.h"
+
+struct ScriptEvent {
+    float time;
+    std::string command;
+    int floor;
+    int car;
+};
+
+static const char* const DEFAULT_SCRIPT =
+    "0    call 1\n"
+    "1    request 6\n"
+    "12   call 3\n"
+    "14   request 0\n"
+    "30   call 7\n"
+    "31   request 2\n"
+    "45   call 5\n"
+    "46   request 1\n"
+    "50   call 4\n"
+    "62   request 7\n";
+
+static bool parseScript(std::istream& in, std::vector<ScriptEvent>& events) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        ScriptEvent e;
+        e.floor = -1;
+        e.car = 0;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue; // blank or comment
+        if (!(ss >> e.time) || !(ss >> e.command)) {
+            std::cout << "Neispravna linija skripte " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+        if (e.command == "call" || e.command == "request") {
+            if (!(ss >> e.floor) || e.floor < 0 || e.floor >= NUM_FLOORS) {
+                std::cout << "Neispravan sprat na liniji " << lineNumber << ": " << line << std::endl;
+                return false;
+            }
+        } else if (e.command != "open" && e.command != "close" && e.command != "stop" && e.command != "vent") {
+            std::cout << "Nepoznata komanda na liniji " << lineNumber << ": " << e.command << std::endl;
+            return false;
+        }
+        if (e.command != "call" && (ss >> e.car) && e.car < 0) {
+            std::cout << "Neispravan lift na liniji " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+        if (!events.empty() && e.time < events.back().time) {
+            std::cout << "Vremena u skripti moraju rasti (linija " << lineNumber << ")" << std::endl;
+            return false;
+        }
+        events.push_back(e);
+    }
+    return true;
+}
+
+// Returns the car that got the command
+static int apply(ElevatorGroup& group, const ScriptEvent& e) {
+    if (e.command == "call") return group.CallToFloor(e.floor);
+
+    Elevator& car = group.Car(e.car);
+    if (e.command == "request") car.RequestFloor(e.floor);
+    else if (e.command == "open") car.OpenDoors();
+    else if (e.command == "close") car.CloseDoors();
+    else if (e.command == "stop") car.ToggleStop();
+    else if (e.command == "vent") car.ToggleVentilation();
+    return e.car;
+}
+
+struct SimResult {
+    long long steps;
+    long long updates; // Update calls actually made
+    long long commands;
+    long long arrivals;
+    double arrivalTimeSum; // for comparing the two modes
+    std::vector<double> latencies; // per call/request, until its floor was served
+    int finalFloor;  // of car 0
+    float finalY;
+    double wallSeconds;
+};
+
+// First step index whose start time is at or after t
+static long long firstStepAt(double t, double dt) {
+    long long s = (long long)ceil(t / dt);
+    while ((double)s * dt < t) s++;
+    while (s > 0 && (double)(s - 1) * dt >= t) s--;
+    return s;
+}
+
+// A floor's waiting calls are served once the request flag of the car they went
+// to is clear: it stopped there, or the call needed no trip at all.
+// waiting[car * NUM_FLOORS + floor] holds their issue times.
+static void collectServed(const ElevatorGroup& group, std::vector<std::vector<double>>& waiting,
+                          double now, std::vector<double>& latencies) {
+    for (int c = 0; c < group.CarCount(); c++) {
+        for (int f = 0; f < NUM_FLOORS; f++) {
+            std::vector<double>& issued = waiting[c * NUM_FLOORS + f];
+            if (issued.empty() || group.Car(c).floorRequests[f]) continue;
+            for (double t : issued)
+                latencies.push_back(now - t);
+            issued.clear();
+        }
+    }
+}
+
+// Replays the script (repeated every period seconds) for duration seconds of steps of dt.
+// Commands due at a step are applied before that step's Update.
+static SimResult runScript(const std::vector<ScriptEvent>& events, double period, double duration,
+                           int cars, float dt, bool eventDriven, SchedulingPolicy policy) {
+    ElevatorGroup group(cars);
+    group.SetScheduler(policy);
+    SimResult result = SimResult();
+    std::vector<std::vector<double>> waiting(cars * NUM_FLOORS);
+    std::vector<bool> wasMoving(cars);
+    long long totalSteps = firstStepAt(duration, dt);
+    long long step = 0;
+    double passStart = 0.0;
+    size_t nextEvent = 0;
+
+    auto wallBegin = std::chrono::steady_clock::now();
+    while (step < totalSteps) {
+        double now = step * (double)dt;
+        if (nextEvent == events.size() && now >= passStart + period) {
+            passStart += period;
+            nextEvent = 0;
+        }
+        while (nextEvent < events.size() && passStart + events[nextEvent].time <= now) {
+            const ScriptEvent& e = events[nextEvent++];
+            int car = apply(group, e);
+            if (e.floor >= 0) waiting[car * NUM_FLOORS + e.floor].push_back(now);
+            result.commands++;
+        }
+        collectServed(group, waiting, now, result.latencies);
+        for (int c = 0; c < cars; c++)
+            wasMoving[c] = group.Car(c).moving;
+
+        long long advance = 1;
+        if (eventDriven) {
+            // Nothing outside the cars happens before the next command (or the next pass)
+            double nextCommand = nextEvent < events.size() ? passStart + events[nextEvent].time : passStart + period;
+            long long horizon = std::min(totalSteps, firstStepAt(nextCommand, dt)) - step;
+            if (horizon < 1) horizon = 1;
+
+            long long toEvent = group.StepsToNextEvent(dt);
+            if (toEvent > 0 && toEvent <= horizon) {
+                group.SkipSteps(toEvent - 1, dt);
+                group.Update(dt);
+                result.updates++;
+                advance = toEvent;
+            } else {
+                group.SkipSteps(horizon, dt);
+                advance = horizon;
+            }
+        } else {
+            group.Update(dt);
+            result.updates++;
+        }
+        step += advance;
+
+        for (int c = 0; c < cars; c++) {
+            if (wasMoving[c] && !group.Car(c).moving) {
+                result.arrivals++;
+                result.arrivalTimeSum += step * (double)dt;
+            }
+        }
+        collectServed(group, waiting, step * (double)dt, result.latencies);
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBegin).count();
+
+    result.steps = step;
+    result.finalFloor = group.Car(0).currentFloor;
+    result.finalY = group.Car(0).currentY;
+    return result;
+}
+
+// Random calls and cab requests, exponentially spaced (mean gap seconds) over duration
+static std::vector<ScriptEvent> generateStream(double duration, double gap, int cars, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> nextGap(1.0 / gap);
+    std::uniform_int_distribution<int> floorPick(0, NUM_FLOORS - 1);
+    std::uniform_int_distribution<int> carPick(0, cars - 1);
+    std::bernoulli_distribution isCall(0.5);
+
+    std::vector<ScriptEvent> events;
+    for (double t = nextGap(rng); t < duration; t += nextGap(rng)) {
+        ScriptEvent e;
+        e.time = (float)t;
+        e.command = isCall(rng) ? "call" : "request";
+        e.floor = floorPick(rng);
+        e.car = carPick(rng);
+        events.push_back(e);
+    }
+    return events;
+}
+
+// Value below which fraction q of the samples fall (sorts samples)
+static double percentile(std::vector<double>& samples, double q) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)ceil(q * samples.size());
+    return samples[index > 0 ? index - 1 : 0];
+}
+
+static void printLatency(SimResult& r) {
+    double sum = 0.0;
+    for (double l : r.latencies) sum += l;
+    double mean = r.latencies.empty() ? 0.0 : sum / r.latencies.size();
+    std::cout << "Latency: mean " << mean << " s, p99 " << percentile(r.latencies, 0.99)
+              << " s over " << r.latencies.size() << " served" << std::endl;
+}
+
+// Passengers through cars for duration, stepping every dt or from event to event
+static PassengerFlow runTraffic(const std::vector<PassengerArrival>& arrivals, double duration,
+                                int cars, float dt, bool eventDriven, SchedulingPolicy policy) {
+    ElevatorGroup group(cars);
+    group.SetScheduler(policy);
+    PassengerFlow flow(arrivals, cars);
+
+    long long endStep = (long long)(duration / dt);
+    long long step = 0;
+    while (step < endStep) {
+        double now = step * (double)dt;
+        flow.Issue(group, now);
+        flow.Exchange(group, now);
+
+        if (!eventDriven) {
+            group.Update(dt);
+            step++;
+            flow.Exchange(group, step * (double)dt);
+            continue;
+        }
+
+        // Nothing outside the cars happens before the next passenger arrives
+        long long horizon = endStep - step;
+        double next = flow.NextArrival();
+        if (next >= 0.0) {
+            long long toArrival = (long long)ceil((next - now) / dt);
+            if (toArrival < 1) toArrival = 1;
+            if (toArrival < horizon) horizon = toArrival;
+        }
+
+        long long toEvent = group.StepsToNextEvent(dt);
+        if (toEvent > 0 && toEvent <= horizon) {
+            group.SkipSteps(toEvent - 1, dt);
+            group.Update(dt);
+            step += toEvent;
+        } else {
+            group.SkipSteps(horizon, dt);
+            step += horizon;
+        }
+        flow.Exchange(group, step * (double)dt);
+    }
+    return flow;
+}
+
+static double mean(const std::vector<double>& samples) {
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+    return samples.empty() ? 0.0 : sum / samples.size();
+}
+
+static void printTraffic(PassengerFlow& flow, double duration) {
+    std::cout << "Delivered " << flow.Delivered() << " of " << flow.Issued()
+              << " (" << flow.Delivered() / (duration / 3600.0) << " per hour), wait: mean "
+              << mean(flow.waitTimes) << " s, p99 " << percentile(flow.waitTimes, 0.99)
+              << " s, journey: mean " << mean(flow.journeyTimes) << " s, p99 "
+              << percentile(flow.journeyTimes, 0.99) << " s" << std::endl;
+}
+
+static void printResult(const char* mode, const SimResult& r, float dt) {
+    double simTime = r.steps * (double)dt;
+    std::cout << "[" << mode << "]" << std::endl;
+    std::cout << "Simulated: " << simTime << " s in " << r.steps << " steps of " << dt << " s ("
+              << r.updates << " Update calls)" << std::endl;
+    std::cout << "Commands: " << r.commands << ", arrivals: " << r.arrivals
+              << ", final floor: " << FLOOR_NAMES[r.finalFloor] << std::endl;
+    std::cout << "Wall time: " << r.wallSeconds << " s" << std::endl;
+    if (r.wallSeconds > 0.0)
+        std::cout << "Throughput: " << simTime / r.wallSeconds << " simulated s per wall s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const char* scriptPath = nullptr;
+    double duration = 24.0 * 3600.0;
+    int cars = NUM_CARS;
+    float dt = TARGET_FRAME_TIME;
+    bool eventDriven = false;
+    bool compare = false;
+    bool benchmark = false;
+    int traffic = -1;
+    double rate = 120.0;
+    unsigned int seed = 1;
+    SchedulingPolicy policy = SCHEDULE_LOOK;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cars") == 0 && i + 1 < argc) cars = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) dt = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--events") == 0) eventDriven = true;
+        else if (strcmp(argv[i], "--compare") == 0) compare = true;
+        else if (strcmp(argv[i], "--benchmark") == 0) benchmark = true;
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--traffic") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            traffic = 0;
+            while (traffic < TRAFFIC_COUNT && strcmp(trafficProfileName((TrafficProfile)traffic), name) != 0) traffic++;
+            if (traffic == TRAFFIC_COUNT) {
+                std::cout << "Nepoznat profil saobracaja: " << name << std::endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            int p = 0;
+            while (p < SCHEDULE_COUNT && strcmp(getScheduler((SchedulingPolicy)p)->Name(), name) != 0) p++;
+            if (p == SCHEDULE_COUNT) {
+                std::cout << "Nepoznata politika: " << name << std::endl;
+                return 1;
+            }
+            policy = (SchedulingPolicy)p;
+        }
+        else if (argv[i][0] != '-') scriptPath = argv[i];
+        else {
+            std::cout << "Upotreba: " << argv[0] << " [skripta] [--cars <n>] [--duration <s>] [--dt <s>] [--events | --compare]"
+                      << " [--policy lowest|look|scan|nearest] [--benchmark [--seed <n>]]"
+                      << " [--traffic interfloor|up-peak|lunch|down-peak|day [--rate <n>] [--seed <n>]]" << std::endl;
+            return 1;
+        }
+    }
+    if (duration <= 0.0 || dt <= 0.0f || cars <= 0 || rate <= 0.0) {
+        std::cout << "Trajanje, korak, broj liftova i protok moraju biti pozitivni" << std::endl;
+        return 1;
+    }
+
+    if (traffic >= 0) {
+        std::vector<PassengerArrival> arrivals = generateTraffic((TrafficProfile)traffic, duration, rate, seed);
+        int incoming = 0, outgoing = 0;
+        for (const PassengerArrival& a : arrivals) {
+            if (a.origin == LOBBY_FLOOR) incoming++;
+            else if (a.destination == LOBBY_FLOOR) outgoing++;
+        }
+        std::cout << "Generated " << arrivals.size() << " passengers (" << incoming << " incoming, "
+                  << outgoing << " outgoing, " << arrivals.size() - incoming - outgoing << " inter-floor) over "
+                  << duration << " s for " << cars << " cars (" << trafficProfileName((TrafficProfile)traffic)
+                  << ", seed " << seed << ")" << std::endl;
+        if (!compare) {
+            for (int p = 0; p < SCHEDULE_COUNT; p++) {
+                PassengerFlow flow = runTraffic(arrivals, duration, cars, dt, true, (SchedulingPolicy)p);
+                std::cout << "[" << getScheduler((SchedulingPolicy)p)->Name() << "] ";
+                printTraffic(flow, duration);
+            }
+            return 0;
+        }
+
+        auto fixedBegin = std::chrono::steady_clock::now();
+        PassengerFlow fixed = runTraffic(arrivals, duration, cars, dt, false, policy);
+        auto eventsBegin = std::chrono::steady_clock::now();
+        PassengerFlow evented = runTraffic(arrivals, duration, cars, dt, true, policy);
+        auto eventsEnd = std::chrono::steady_clock::now();
+        std::cout << "[fixed] ";
+        printTraffic(fixed, duration);
+        std::cout << "[events] ";
+        printTraffic(evented, duration);
+        std::cout << "[difference]" << std::endl;
+        std::cout << "Delivered: " << evented.Delivered() - fixed.Delivered()
+                  << ", mean wait: " << mean(evented.waitTimes) - mean(fixed.waitTimes) << " s"
+                  << ", mean journey: " << mean(evented.journeyTimes) - mean(fixed.journeyTimes) << " s" << std::endl;
+        double eventsWall = std::chrono::duration<double>(eventsEnd - eventsBegin).count();
+        if (eventsWall > 0.0)
+            std::cout << "Speedup: " << std::chrono::duration<double>(eventsBegin - fixedBegin).count() / eventsWall
+                      << "x" << std::endl;
+        return 0;
+    }
+
+    if (benchmark) {
+        // One pass of a random stream, so no repeats: the period is past the end
+        std::vector<ScriptEvent> stream = generateStream(duration, 8.0 / cars, cars, seed);
+        std::cout << "Generated " << stream.size() << " calls over " << duration << " s for "
+                  << cars << " cars (seed " << seed << ")" << std::endl;
+        for (int p = 0; p < SCHEDULE_COUNT; p++) {
+            SimResult r = runScript(stream, duration * 2.0, duration, cars, dt, true, (SchedulingPolicy)p);
+            std::cout << "[" << getScheduler((SchedulingPolicy)p)->Name() << "] ";
+            printLatency(r);
+        }
+        return 0;
+    }
+
+    std::vector<ScriptEvent> events;
+    if (scriptPath != nullptr) {
+        std::ifstream file(scriptPath);
+        if (!file.is_open()) {
+            std::cout << "Skripta nije ucitana! Putanja skripte: " << scriptPath << std::endl;
+            return 1;
+        }
+        if (!parseScript(file, events)) return 1;
+    } else {
+        std::istringstream builtIn(DEFAULT_SCRIPT);
+        parseScript(builtIn, events);
+    }
+    if (events.empty()) {
+        std::cout << "Skripta je prazna" << std::endl;
+        return 1;
+    }
+    for (const ScriptEvent& e : events) {
+        if (e.car >= cars) {
+            std::cout << "Skripta koristi lift " << e.car << ", a ima ih " << cars << std::endl;
+            return 1;
+        }
+    }
+
+    // Leave room for the last stop's doors before the script starts over
+    double period = events.back().time + DOOR_OPEN_TIME + 2.0 / DOOR_SPEED;
+
+    if (!compare) {
+        SimResult r = runScript(events, period, duration, cars, dt, eventDriven, policy);
+        printResult(eventDriven ? "events" : "fixed", r, dt);
+        printLatency(r);
+        return 0;
+    }
+
+    SimResult fixed = runScript(events, period, duration, cars, dt, false, policy);
+    SimResult evented = runScript(events, period, duration, cars, dt, true, policy);
+    printResult("fixed", fixed, dt);
+    printResult("events", evented, dt);
+
+    double meanFixed = fixed.arrivals > 0 ? fixed.arrivalTimeSum / fixed.arrivals : 0.0;
+    double meanEvents = evented.arrivals > 0 ? evented.arrivalTimeSum / evented.arrivals : 0.0;
+    std::cout << "[difference]" << std::endl;
+    std::cout << "Arrivals: " << evented.arrivals - fixed.arrivals
+              << ", mean arrival time: " << meanEvents - meanFixed << " s"
+              << ", final position: " << evented.finalY - fixed.finalY << " m" << std::endl;
+    if (evented.wallSeconds > 0.0)
+        std::cout << "Speedup: " << fixed.wallSeconds / evented.wallSeconds << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include "../Header/InstanceRenderer.h"
+#include "../Header/GLState.h"
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/matrix_inverse.hpp>
+
+InstanceRenderer::InstanceRenderer()
+    : useTextureLoc(-1), frustum(nullptr), lightManager(nullptr),
+      viewPos(0.0f), currentPass(PASS_OPAQUE)
+{
+    stats = RenderStats();
+}
+
+void InstanceRenderer::Init(const BasicShader& shader) {
+    instanceStream.Init(GL_ARRAY_BUFFER);
+    useTextureLoc = shader.useTexture;
+}
+
+void InstanceRenderer::Destroy() {
+    instanceStream.Destroy();
+    batches.clear();
+    attachedVAOs.clear();
+}
+
+// Normal matrix for model. Rotation with uniform scale only changes a normal's length,
+// which basic.frag normalizes away, so mat3(model) is used directly; the
+// inverse-transpose is only needed for non-uniform scale (most walls and slabs).
+static glm::mat3 normalMatrixFor(const glm::mat4& model) {
+    glm::mat3 m(model);
+    float lx = glm::dot(m[0], m[0]);
+    float ly = glm::dot(m[1], m[1]);
+    float lz = glm::dot(m[2], m[2]);
+    float tolerance = 1e-4f * (lx + ly + lz);
+
+    bool uniformScale = fabs(lx - ly) < tolerance && fabs(lx - lz) < tolerance;
+    bool orthogonal = fabs(glm::dot(m[0], m[1])) < tolerance &&
+                      fabs(glm::dot(m[0], m[2])) < tolerance &&
+                      fabs(glm::dot(m[1], m[2])) < tolerance;
+    if (uniformScale && orthogonal)
+        return m;
+    return glm::inverseTranspose(m);
+}
+
+// Distance from p to the nearest point of box (0 inside it)
+static float distanceTo(const AABB& box, const glm::vec3& p) {
+    glm::vec3 outside = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+    return glm::length(outside);
+}
+
+// Sort key, most significant first: pass (3 bits) | VAO (8) | texture (12) |
+// nearest depth (24) | batch (17). Switching between arena meshes needs no state,
+// so depth ranks above mesh and the groups sharing a texture go front to back.
+// GL names are small, so their low bits are enough to keep equal ones together.
+static uint64_t sortKey(RenderPass pass, unsigned int vao, unsigned int texture, float depth, size_t batch) {
+    // Non-negative floats order like their bit patterns; the top 24 bits (below the sign) are plenty
+    uint32_t depthBits;
+    memcpy(&depthBits, &depth, sizeof(depthBits));
+    return ((uint64_t)pass << 61) |
+           ((uint64_t)(vao & 0xFFu) << 53) |
+           ((uint64_t)(texture & 0xFFFu) << 41) |
+           ((uint64_t)(depthBits >> 7) << 17) |
+           (uint64_t)(batch & 0x1FFFFu);
+}
+
+void InstanceRenderer::BeginFrame(const Frustum* viewFrustum, const glm::vec3& viewPosition, const LightManager* lights) {
+    frustum = viewFrustum;
+    viewPos = viewPosition;
+    lightManager = lights;
+    currentPass = PASS_OPAQUE;
+    stats = RenderStats();
+}
+
+bool InstanceRenderer::IsVisible(const AABB& worldBounds) {
+    if (frustum != nullptr && !frustum->IsVisible(worldBounds)) {
+        stats.objectsCulled++;
+        return false;
+    }
+    stats.objectsVisible++;
+    return true;
+}
+
+// Packs the lights reaching worldBounds one byte each; a count above
+// LIGHT_LIST_SIZE tells basic.frag to read its cluster instead
+glm::uvec2 InstanceRenderer::lightListFor(const AABB& worldBounds) {
+    if (lightManager == nullptr)
+        return glm::uvec2(0u, (unsigned int)LIGHT_LIST_SIZE + 1u);
+
+    int indices[LIGHT_LIST_SIZE];
+    int count = lightManager->LightsAffecting(worldBounds, indices, LIGHT_LIST_SIZE);
+    if (count > LIGHT_LIST_SIZE)
+        return glm::uvec2(0u, (unsigned int)count);
+
+    unsigned int packed = 0;
+    for (int i = 0; i < count; i++)
+        packed |= (unsigned int)indices[i] << (8 * i);
+    stats.lightListed++;
+    return glm::uvec2(packed, (unsigned int)count);
+}
+
+InstanceRenderer::Batch& InstanceRenderer::findBatch(unsigned int vao, const Mesh& mesh, unsigned int texture,
+                                                     bool layered, bool vertexColor) {
+    for (Batch& b : batches) {
+        if (b.pass == currentPass && b.vao == vao && b.mesh.baseVertex == mesh.baseVertex && b.mesh.firstIndex == mesh.firstIndex &&
+            b.mesh.indexCount == mesh.indexCount && b.mesh.indexType == mesh.indexType && b.texture == texture && b.layered == layered &&
+            b.vertexColor == vertexColor)
+            return b;
+    }
+    Batch b;
+    b.pass = currentPass;
+    b.vao = vao;
+    b.mesh = mesh;
+    b.texture = texture;
+    b.layered = layered;
+    b.vertexColor = vertexColor;
+    b.nearest = 0.0f;
+    batches.push_back(b);
+    return batches.back();
+}
+
+void InstanceRenderer::addInstance(Batch& batch, const InstanceData& inst, const AABB& worldBounds) {
+    float depth = distanceTo(worldBounds, viewPos);
+    if (batch.instances.empty() || depth < batch.nearest)
+        batch.nearest = depth;
+    batch.instances.push_back(inst);
+    batch.depths.push_back(depth);
+}
+
+void InstanceRenderer::Push(const Mesh& mesh, const glm::mat4& model, glm::vec3 color,
+                            glm::vec4 emissive, unsigned int texture) {
+    AABB worldBounds = transformAABB(mesh.bounds, model);
+    if (!IsVisible(worldBounds)) return;
+
+    InstanceData inst;
+    inst.model = model;
+    inst.color = color;
+    inst.emissive = emissive;
+    inst.normalMatrix = normalMatrixFor(model);
+    inst.lightList = lightListFor(worldBounds);
+    inst.textureLayer = -1;
+    addInstance(findBatch(getMeshArenaVAO(), mesh, texture, false, false), inst, worldBounds);
+}
+
+void InstanceRenderer::PushLayer(const Mesh& mesh, const glm::mat4& model, glm::vec3 color, glm::vec4 emissive,
+                                 unsigned int textureArray, int layer) {
+    AABB worldBounds = transformAABB(mesh.bounds, model);
+    if (!IsVisible(worldBounds)) return;
+
+    InstanceData inst;
+    inst.model = model;
+    inst.color = color;
+    inst.emissive = emissive;
+    inst.normalMatrix = normalMatrixFor(model);
+    inst.lightList = lightListFor(worldBounds);
+    inst.textureLayer = textureArray != 0 ? layer : -1;
+    addInstance(findBatch(getMeshArenaVAO(), mesh, textureArray, textureArray != 0, false), inst, worldBounds);
+}
+
+void InstanceRenderer::PushVertexColored(unsigned int vao, int firstIndex, int indexCount, const glm::mat4& model,
+                                         const AABB& worldBounds) {
+    Mesh mesh;
+    mesh.baseVertex = 0;
+    mesh.firstIndex = firstIndex;
+    mesh.indexType = GL_UNSIGNED_INT;
+    mesh.indexCount = indexCount;
+
+    InstanceData inst;
+    inst.model = model;
+    inst.color = glm::vec3(1.0f);
+    inst.emissive = glm::vec4(0.0f);
+    inst.normalMatrix = normalMatrixFor(model);
+    inst.lightList = lightListFor(worldBounds);
+    inst.textureLayer = -1;
+    addInstance(findBatch(vao, mesh, 0, false, true), inst, worldBounds);
+}
+
+// Points the instance attributes of the bound VAO at firstInstance in the stream buffer.
+// Without base-instance draws this is how each group finds its slice.
+void InstanceRenderer::bindInstanceAttributes(size_t firstInstance, bool vertexColor) const {
+    GLsizei stride = sizeof(InstanceData);
+    size_t base = firstInstance * sizeof(InstanceData);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceStream.Id());
+
+    // Meshes with per-vertex colour keep their own attribute 3
+    if (!vertexColor) {
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(InstanceData, color)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+    }
+
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(InstanceData, emissive)));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
+    // mat4 takes four consecutive locations, one column each
+    for (int col = 0; col < 4; col++) {
+        GLuint loc = 5 + col;
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(InstanceData, model) + col * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+
+    // mat3 normal matrix, locations 9..11
+    for (int col = 0; col < 3; col++) {
+        GLuint loc = 9 + col;
+        glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(InstanceData, normalMatrix) + col * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+
+    // Integer attribute, so it must not go through the float path
+    glVertexAttribIPointer(12, 2, GL_UNSIGNED_INT, stride, (void*)(base + offsetof(InstanceData, lightList)));
+    glEnableVertexAttribArray(12);
+    glVertexAttribDivisor(12, 1);
+
+    glVertexAttribIPointer(13, 1, GL_INT, stride, (void*)(base + offsetof(InstanceData, textureLayer)));
+    glEnableVertexAttribArray(13);
+    glVertexAttribDivisor(13, 1);
+}
+
+void InstanceRenderer::Flush() {
+    drawOrder.clear();
+    for (size_t i = 0; i < batches.size(); i++) {
+        const Batch& b = batches[i];
+        if (!b.instances.empty())
+            drawOrder.push_back(std::make_pair(sortKey(b.pass, b.vao, b.texture, b.nearest, i), i));
+    }
+    if (drawOrder.empty()) return;
+    std::sort(drawOrder.begin(), drawOrder.end());
+
+    size_t total = 0;
+    for (const std::pair<uint64_t, size_t>& entry : drawOrder)
+        total += batches[entry.second].instances.size();
+
+    // Gather the batches in draw order straight into this frame's region, each
+    // one's instances nearest first so early depth testing rejects what they hide
+    InstanceData* dst = (InstanceData*)instanceStream.Map(total * sizeof(InstanceData));
+    if (dst == nullptr) {
+        for (Batch& b : batches) {
+            b.instances.clear();
+            b.depths.clear();
+        }
+        return;
+    }
+    for (const std::pair<uint64_t, size_t>& entry : drawOrder) {
+        const Batch& b = batches[entry.second];
+        instanceOrder.resize(b.instances.size());
+        for (size_t i = 0; i < instanceOrder.size(); i++)
+            instanceOrder[i] = i;
+        std::sort(instanceOrder.begin(), instanceOrder.end(),
+            [&b](size_t x, size_t y) { return b.depths[x] < b.depths[y]; });
+        for (size_t i : instanceOrder)
+            *dst++ = b.instances[i];
+    }
+    instanceStream.Unmap();
+
+    // With base-instance draws every VAO points at instance 0 once and each group
+    // selects its slice through baseinstance instead of re-pointing attributes
+    bool baseInstance = GLEW_ARB_base_instance != 0;
+
+    // Double-sided passes turn culling off; the caller's setting comes back afterwards
+    bool cullFace = stateIsEnabled(GL_CULL_FACE);
+
+    // Regions hold a whole number of instances, so the region start is an instance index too
+    size_t first = instanceStream.RegionOffset() / sizeof(InstanceData);
+    for (const std::pair<uint64_t, size_t>& entry : drawOrder) {
+        Batch& b = batches[entry.second];
+        stateSetEnabled(GL_CULL_FACE, cullFace && b.pass == PASS_OPAQUE);
+
+        // Textures stay bound after the draw; the state cache skips rebinding them
+        if (b.layered) {
+            stateBindTexture(3, GL_TEXTURE_2D_ARRAY, b.texture); // layer comes per instance
+        } else if (b.texture != 0) {
+            glUniform1i(useTextureLoc, 1);
+            stateBindTexture(0, GL_TEXTURE_2D, b.texture);
+        }
+        stateBindVertexArray(b.vao);
+
+        const void* indexOffset = meshIndexOffset(b.mesh);
+        GLsizei count = (GLsizei)b.instances.size();
+        if (baseInstance) {
+            if (std::find(attachedVAOs.begin(), attachedVAOs.end(), b.vao) == attachedVAOs.end()) {
+                bindInstanceAttributes(0, b.vertexColor);
+                attachedVAOs.push_back(b.vao);
+            }
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, b.mesh.indexCount, b.mesh.indexType,
+                indexOffset, count, b.mesh.baseVertex, (GLuint)first);
+        } else {
+            bindInstanceAttributes(first, b.vertexColor);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, b.mesh.indexCount, b.mesh.indexType,
+                indexOffset, count, b.mesh.baseVertex);
+        }
+
+        if (b.texture != 0 && !b.layered)
+            glUniform1i(useTextureLoc, 0);
+
+        stats.drawCalls++;
+        stats.instances += (int)b.instances.size();
+        stats.triangles += b.mesh.indexCount / 3 * (int)b.instances.size();
+        first += b.instances.size();
+        b.instances.clear();
+        b.depths.clear();
+    }
+
+    stateSetEnabled(GL_CULL_FACE, cullFace);
+    instanceStream.Advance();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,184 @@
+#include "../Header/LightClusters.h"
+#include "../Header/GLState.h"
+#include <cmath>
+#include <algorithm>
+
+static const int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+// Exponential slicing: slice = log(z / near) / log(far / near) * CLUSTER_Z
+static int sliceForDepth(float z) {
+    if (z <= CAMERA_NEAR) return 0;
+    int s = (int)(logf(z / CAMERA_NEAR) / logf(CAMERA_FAR / CAMERA_NEAR) * CLUSTER_Z);
+    return std::min(s, CLUSTER_Z - 1);
+}
+
+static int clampTile(float ndc, int tiles) {
+    int t = (int)floorf((ndc * 0.5f + 0.5f) * tiles);
+    return std::max(0, std::min(t, tiles - 1));
+}
+
+LightClusters::LightClusters()
+    : gridBuffer(0), gridTexture(0), indexBuffer(0), indexTexture(0), indexCapacity(0),
+      lastView(0.0f), lastProjection(0.0f), lastVersion(0), valid(false)
+{
+}
+
+void LightClusters::Init() {
+    grid.assign(CLUSTER_COUNT * 2, 0);
+
+    glGenBuffers(1, &gridBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, grid.size() * sizeof(unsigned int), grid.data(), GL_DYNAMIC_DRAW);
+
+    // One reference per light to start with; grows on demand in Update
+    indexCapacity = MAX_LIGHTS;
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, indexCapacity * sizeof(unsigned short), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // Bound straight onto the units Bind uses, so per-frame binds are no-ops
+    glGenTextures(1, &gridTexture);
+    stateBindTexture(1, GL_TEXTURE_BUFFER, gridTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, gridBuffer);
+
+    glGenTextures(1, &indexTexture);
+    stateBindTexture(2, GL_TEXTURE_BUFFER, indexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, indexBuffer);
+
+    valid = false;
+}
+
+void LightClusters::Destroy() {
+    if (gridTexture != 0) glDeleteTextures(1, &gridTexture);
+    if (indexTexture != 0) glDeleteTextures(1, &indexTexture);
+    if (gridBuffer != 0) glDeleteBuffers(1, &gridBuffer);
+    if (indexBuffer != 0) glDeleteBuffers(1, &indexBuffer);
+    gridTexture = indexTexture = gridBuffer = indexBuffer = 0;
+    indexCapacity = 0;
+}
+
+bool LightClusters::computeRange(const AABB& box, const glm::mat4& view, const glm::mat4& projection, LightRange& out) const {
+    if (box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z)
+        return false; // clipped away entirely
+
+    float zMin = CAMERA_FAR, zMax = 0.0f;
+    glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+    bool behindNear = false;
+
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 corner(
+            (i & 1) ? box.max.x : box.min.x,
+            (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z
+        );
+        glm::vec4 v = view * glm::vec4(corner, 1.0f);
+        float z = -v.z; // view space looks down -Z
+        zMin = std::min(zMin, z);
+        zMax = std::max(zMax, z);
+
+        if (z < CAMERA_NEAR) {
+            behindNear = true;
+            continue;
+        }
+        glm::vec4 clip = projection * v;
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+
+    if (zMax < CAMERA_NEAR || zMin > CAMERA_FAR)
+        return false;
+
+    // A box straddling the near plane can project anywhere on screen
+    if (behindNear) {
+        ndcMin = glm::vec2(-1.0f);
+        ndcMax = glm::vec2(1.0f);
+    }
+    if (ndcMin.x > 1.0f || ndcMin.y > 1.0f || ndcMax.x < -1.0f || ndcMax.y < -1.0f)
+        return false;
+
+    out.x0 = clampTile(ndcMin.x, CLUSTER_X);
+    out.x1 = clampTile(ndcMax.x, CLUSTER_X);
+    out.y0 = clampTile(ndcMin.y, CLUSTER_Y);
+    out.y1 = clampTile(ndcMax.y, CLUSTER_Y);
+    out.z0 = sliceForDepth(zMin);
+    out.z1 = sliceForDepth(zMax);
+    return true;
+}
+
+void LightClusters::Update(const LightManager& lightManager, const glm::mat4& view, const glm::mat4& projection) {
+    if (gridBuffer == 0) return;
+    if (valid && lightManager.Version() == lastVersion && view == lastView && projection == lastProjection)
+        return;
+
+    int lightCount = std::min((int)lightManager.lights.size(), MAX_LIGHTS);
+
+    // Pass 1: cluster range of every active light, and per-cluster counts
+    ranges.clear();
+    std::fill(grid.begin(), grid.end(), 0u);
+    for (int i = 0; i < lightCount; i++) {
+        if (!lightManager.lights[i].active) continue;
+
+        LightRange r;
+        r.light = i;
+        if (!computeRange(lightManager.InfluenceBounds(i), view, projection, r)) continue;
+        ranges.push_back(r);
+
+        for (int z = r.z0; z <= r.z1; z++)
+            for (int y = r.y0; y <= r.y1; y++)
+                for (int x = r.x0; x <= r.x1; x++)
+                    grid[((z * CLUSTER_Y + y) * CLUSTER_X + x) * 2 + 1]++;
+    }
+
+    // Pass 2: prefix sum into offsets, then reset counts for the fill
+    unsigned int total = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++) {
+        grid[c * 2] = total;
+        total += grid[c * 2 + 1];
+        grid[c * 2 + 1] = 0;
+    }
+
+    // Pass 3: scatter light indices
+    indices.resize(total);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        const LightRange& r = ranges[i];
+        for (int z = r.z0; z <= r.z1; z++)
+            for (int y = r.y0; y <= r.y1; y++)
+                for (int x = r.x0; x <= r.x1; x++) {
+                    unsigned int* cell = &grid[((z * CLUSTER_Y + y) * CLUSTER_X + x) * 2];
+                    indices[cell[0] + cell[1]] = (unsigned short)r.light;
+                    cell[1]++;
+                }
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, grid.size() * sizeof(unsigned int), grid.data());
+
+    glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+    if (indices.size() > indexCapacity) {
+        while (indexCapacity < indices.size()) indexCapacity *= 2;
+        glBufferData(GL_TEXTURE_BUFFER, indexCapacity * sizeof(unsigned short), NULL, GL_DYNAMIC_DRAW);
+    }
+    if (!indices.empty())
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, indices.size() * sizeof(unsigned short), indices.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    lastView = view;
+    lastProjection = projection;
+    lastVersion = lightManager.Version();
+    valid = true;
+}
+
+void LightClusters::Bind(const BasicShader& shader, int screenWidth, int screenHeight) const {
+    stateBindTexture(1, GL_TEXTURE_BUFFER, gridTexture);
+    stateBindTexture(2, GL_TEXTURE_BUFFER, indexTexture);
+
+    // Same mapping as sliceForDepth, folded into slice = log(z) * scale + bias
+    float logRange = logf(CAMERA_FAR / CAMERA_NEAR);
+    glUniform1f(shader.clusterSliceScale, CLUSTER_Z / logRange);
+    glUniform1f(shader.clusterSliceBias, -CLUSTER_Z * logf(CAMERA_NEAR) / logRange);
+    glUniform2f(shader.clusterTileScale,
+        (float)CLUSTER_X / (float)std::max(screenWidth, 1),
+        (float)CLUSTER_Y / (float)std::max(screenHeight, 1));
+}
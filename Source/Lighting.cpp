@@ -1,6 +1,52 @@
 #include "../Header/Lighting.h"
-#include <glm/gtc/type_ptr.hpp>
-#include <string>
+#include <cmath>
+#include <algorithm>
+
+static_assert(sizeof(GpuLight) == 64, "GpuLight must match the std140 layout of Light");
+
+LightManager::LightManager()
+    : ubo(0), dirtyBegin(0), dirtyEnd(0), version(0)
+{
+}
+
+void LightManager::Init() {
+    GLsizeiptr size = MAX_LIGHTS * sizeof(GpuLight);
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, ubo);
+
+    // Lights added before Init still need their first upload
+    dirtyBegin = 0;
+    dirtyEnd = (int)lights.size();
+}
+
+void LightManager::Destroy() {
+    if (ubo) glDeleteBuffers(1, &ubo);
+    ubo = 0;
+}
+
+int LightManager::addLight(const PointLight& light) {
+    lights.push_back(light);
+    int index = (int)lights.size() - 1;
+    markDirty(index);
+    return index;
+}
+
+void LightManager::markDirty(int index) {
+    version++;
+    if (influence.size() < lights.size()) influence.resize(lights.size());
+    influence[index] = InfluenceBounds(index);
+
+    if (dirtyBegin >= dirtyEnd) {
+        dirtyBegin = index;
+        dirtyEnd = index + 1;
+    } else {
+        if (index < dirtyBegin) dirtyBegin = index;
+        if (index + 1 > dirtyEnd) dirtyEnd = index + 1;
+    }
+}
 
 int LightManager::AddFloorLight(int floorIndex) {
     PointLight light;
@@ -12,13 +58,16 @@ int LightManager::AddFloorLight(int floorIndex) {
     light.linear = 0.09f;
     light.quadratic = 0.032f;
     light.active = true;
-    lights.push_back(light);
-    return (int)lights.size() - 1;
+    // The slabs above and below block it
+    light.clipped = true;
+    light.clipBounds.min = glm::vec3(-BUILDING_WIDTH / 2.0f, floorIndex * FLOOR_HEIGHT - 0.1f, -BUILDING_DEPTH);
+    light.clipBounds.max = glm::vec3(BUILDING_WIDTH / 2.0f, (floorIndex + 1) * FLOOR_HEIGHT, 0.0f);
+    return addLight(light);
 }
 
-int LightManager::AddElevatorLight(float elevatorY) {
+int LightManager::AddElevatorLight(float carX, float elevatorY) {
     PointLight light;
-    light.position = glm::vec3(SHAFT_CENTER_X, elevatorY + ELEVATOR_HEIGHT - 0.2f, SHAFT_CENTER_Z);
+    light.position = glm::vec3(carX, elevatorY + ELEVATOR_HEIGHT - 0.2f, SHAFT_CENTER_Z);
     light.ambient = glm::vec3(0.15f, 0.15f, 0.12f);
     light.diffuse = glm::vec3(0.9f, 0.85f, 0.7f);
     light.specular = glm::vec3(0.6f, 0.6f, 0.5f);
@@ -26,8 +75,8 @@ int LightManager::AddElevatorLight(float elevatorY) {
     light.linear = 0.14f;
     light.quadratic = 0.07f;
     light.active = true;
-    lights.push_back(light);
-    return (int)lights.size() - 1;
+    light.clipped = false;
+    return addLight(light);
 }
 
 int LightManager::AddButtonGlow(glm::vec3 position) {
@@ -40,37 +89,98 @@ int LightManager::AddButtonGlow(glm::vec3 position) {
     light.linear = 1.4f;
     light.quadratic = 3.6f;
     light.active = false;
-    lights.push_back(light);
-    return (int)lights.size() - 1;
+    light.clipped = false;
+    return addLight(light);
 }
 
 void LightManager::UpdateLightPosition(int index, glm::vec3 newPos) {
-    if (index >= 0 && index < (int)lights.size()) {
+    if (index >= 0 && index < (int)lights.size() && lights[index].position != newPos) {
         lights[index].position = newPos;
+        markDirty(index);
     }
 }
 
 void LightManager::SetLightActive(int index, bool active) {
-    if (index >= 0 && index < (int)lights.size()) {
+    if (index >= 0 && index < (int)lights.size() && lights[index].active != active) {
         lights[index].active = active;
+        markDirty(index);
     }
 }
 
-void LightManager::UploadToShader(unsigned int shaderProgram) const {
+void LightManager::Upload() {
+    if (ubo == 0) return;
+
     int count = (int)lights.size();
     if (count > MAX_LIGHTS) count = MAX_LIGHTS;
+    if (dirtyEnd > count) dirtyEnd = count;
+    if (dirtyBegin >= dirtyEnd) return;
+
+    staging.resize(dirtyEnd - dirtyBegin);
+    for (int i = dirtyBegin; i < dirtyEnd; i++) {
+        const PointLight& l = lights[i];
+        GpuLight& g = staging[i - dirtyBegin];
+        g.position = l.position;
+        g.constant = l.constant;
+        g.ambient = l.ambient;
+        g.linear = l.linear;
+        g.diffuse = l.diffuse;
+        g.quadratic = l.quadratic;
+        g.specular = l.specular;
+        g.active = l.active ? 1 : 0;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, dirtyBegin * sizeof(GpuLight),
+        staging.size() * sizeof(GpuLight), staging.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    dirtyBegin = dirtyEnd = 0;
+}
 
-    glUniform1i(glGetUniformLocation(shaderProgram, "numLights"), count);
+float LightManager::EffectiveRadius(int index) const {
+    const PointLight& l = lights[index];
+    // Brightest channel the light can contribute at distance 0
+    glm::vec3 peak = glm::max(glm::max(l.ambient, l.diffuse), l.specular);
+    float intensity = std::max(peak.r, std::max(peak.g, peak.b));
 
+    // Solve intensity / (c + l*d + q*d^2) = LIGHT_CUTOFF for d
+    float target = intensity / LIGHT_CUTOFF;
+    float c = l.constant - target;
+    if (c >= 0.0f) return 0.0f; // never bright enough to matter
+    if (l.quadratic > 0.0f)
+        return (-l.linear + sqrtf(l.linear * l.linear - 4.0f * l.quadratic * c)) / (2.0f * l.quadratic);
+    if (l.linear > 0.0f)
+        return -c / l.linear;
+    return CAMERA_FAR;
+}
+
+AABB LightManager::InfluenceBounds(int index) const {
+    const PointLight& l = lights[index];
+    float r = EffectiveRadius(index);
+
+    AABB box;
+    box.min = l.position - glm::vec3(r);
+    box.max = l.position + glm::vec3(r);
+    if (l.clipped) {
+        box.min = glm::max(box.min, l.clipBounds.min);
+        box.max = glm::min(box.max, l.clipBounds.max);
+    }
+    return box;
+}
+
+int LightManager::LightsAffecting(const AABB& box, int* out, int maxCount) const {
+    int count = std::min((int)lights.size(), MAX_LIGHTS);
+    int found = 0;
     for (int i = 0; i < count; i++) {
-        std::string base = "lights[" + std::to_string(i) + "].";
-        glUniform3fv(glGetUniformLocation(shaderProgram, (base + "position").c_str()), 1, glm::value_ptr(lights[i].position));
-        glUniform3fv(glGetUniformLocation(shaderProgram, (base + "ambient").c_str()), 1, glm::value_ptr(lights[i].ambient));
-        glUniform3fv(glGetUniformLocation(shaderProgram, (base + "diffuse").c_str()), 1, glm::value_ptr(lights[i].diffuse));
-        glUniform3fv(glGetUniformLocation(shaderProgram, (base + "specular").c_str()), 1, glm::value_ptr(lights[i].specular));
-        glUniform1f(glGetUniformLocation(shaderProgram, (base + "constant").c_str()), lights[i].constant);
-        glUniform1f(glGetUniformLocation(shaderProgram, (base + "linear").c_str()), lights[i].linear);
-        glUniform1f(glGetUniformLocation(shaderProgram, (base + "quadratic").c_str()), lights[i].quadratic);
-        glUniform1i(glGetUniformLocation(shaderProgram, (base + "active").c_str()), lights[i].active ? 1 : 0);
+        if (!lights[i].active) continue;
+
+        const AABB& b = influence[i];
+        if (b.min.x > box.max.x || b.max.x < box.min.x ||
+            b.min.y > box.max.y || b.max.y < box.min.y ||
+            b.min.z > box.max.z || b.max.z < box.min.z)
+            continue;
+
+        if (found == maxCount) return maxCount + 1;
+        out[found++] = i;
     }
+    return found;
 }
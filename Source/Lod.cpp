@@ -0,0 +1,66 @@
+#include "../Header/Lod.h"
+#include <cmath>
+
+// Projected diameter in pixels above which each level is too coarse
+// (level i is used while the object is at most LOD_SWITCH_PIXELS[i - 1])
+static const float LOD_SWITCH_PIXELS[LOD_LEVELS - 1] = { 120.0f, 40.0f };
+static const float LOD_HYSTERESIS = 0.15f; // fraction a size must pass a threshold by
+
+LodMesh createCylinderLods() {
+    LodMesh lods;
+    lods.levels[0] = createCylinderMesh(16);
+    lods.levels[1] = createCylinderMesh(10);
+    lods.levels[2] = createCylinderMesh(6);
+    return lods;
+}
+
+LodMesh createSphereLods() {
+    LodMesh lods;
+    lods.levels[0] = createSphereMesh(12, 24);
+    lods.levels[1] = createSphereMesh(8, 16);
+    lods.levels[2] = createSphereMesh(5, 10);
+    return lods;
+}
+
+LodMesh createConeLods() {
+    LodMesh lods;
+    lods.levels[0] = createConeMesh(16);
+    lods.levels[1] = createConeMesh(10);
+    lods.levels[2] = createConeMesh(6);
+    return lods;
+}
+
+LodSelector::LodSelector()
+    : cameraPos(0.0f), pixelsPerUnit(1.0f)
+{
+}
+
+void LodSelector::BeginFrame(glm::vec3 camPos, float fovYDegrees, int screenHeight) {
+    cameraPos = camPos;
+    pixelsPerUnit = screenHeight / (2.0f * tanf(glm::radians(fovYDegrees) * 0.5f));
+}
+
+const Mesh& LodSelector::Select(const LodMesh& lods, int id, const glm::mat4& model) {
+    if (id >= (int)current.size()) current.resize(id + 1, -1);
+
+    // Bounding sphere of the transformed bounds
+    AABB box = transformAABB(lods.levels[0].bounds, model);
+    glm::vec3 center = (box.min + box.max) * 0.5f;
+    float radius = glm::length(box.max - box.min) * 0.5f;
+    float distance = glm::length(center - cameraPos);
+    float pixels = distance > radius ? 2.0f * radius / distance * pixelsPerUnit : 1e9f;
+
+    // Level without hysteresis
+    int target = 0;
+    while (target < LOD_LEVELS - 1 && pixels <= LOD_SWITCH_PIXELS[target]) target++;
+
+    int& level = current[id];
+    if (level < 0) {
+        level = target;
+    } else {
+        // Step only across thresholds passed by more than the hysteresis band
+        while (level > target && pixels > LOD_SWITCH_PIXELS[level - 1] * (1.0f + LOD_HYSTERESIS)) level--;
+        while (level < target && pixels < LOD_SWITCH_PIXELS[level] * (1.0f - LOD_HYSTERESIS)) level++;
+    }
+    return lods.levels[level];
+}
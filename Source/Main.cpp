@@ -5,24 +5,40 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <future>
 
 #include "../Header/Util.h"
 #include "../Header/Constants.h"
 #include "../Header/Camera.h"
 #include "../Header/Mesh.h"
-#include "../Header/Elevator.h"
+#include "../Header/ElevatorGroup.h"
 #include "../Header/Lighting.h"
 #include "../Header/Building.h"
 #include "../Header/ButtonPanel.h"
+#include "../Header/ShaderProgram.h"
+#include "../Header/InstanceRenderer.h"
+#include "../Header/Visibility.h"
+#include "../Header/LightClusters.h"
+#include "../Header/TextureArray.h"
+#include "../Header/AssetLoader.h"
+#include "../Header/Lod.h"
+#include "../Header/GLState.h"
 
 // ============ GLOBALS ============
 Camera camera(glm::vec3(0.0f, FLOOR_HEIGHT + PLAYER_HEIGHT, -3.0f), -90.0f, 0.0f);
-Elevator elevator;
+ElevatorGroup elevators;
 Building building;
 ButtonPanel buttonPanel;
 LightManager lightManager;
+LightClusters lightClusters;
+InstanceRenderer instanceRenderer;
+VisibilityTable visibilityTable;
+LodSelector lodSelector; // ids: Building's first, then one bulb per floor and one per cab
 
 bool playerInElevator = false;
+int playerCar = 0;   // car the player rides, or rode last; the button panel is in this one
 int playerFloor = 1; // Start at PR (ground floor)
 
 float deltaTime = 0.0f;
@@ -31,15 +47,16 @@ bool firstMouse = true;
 
 bool depthTestEnabled = true;
 bool cullingEnabled = true;
+bool printStats = false;
 
 bool keys[1024] = { false };
-int elevatorLightIdx = -1;
+int elevatorLightIdx[NUM_CARS];
 
 int screenWidth = 0, screenHeight = 0;
 
 // Textures
-unsigned int btnTextures[12] = { 0 };
-unsigned int floorTextures[8] = { 0 };
+unsigned int btnTextureArray = 0;   // btn_0..btn_11, one layer each
+unsigned int floorTextureArray = 0; // floor_0..floor_7
 unsigned int studentInfoTex = 0;
 
 // ============ CALLBACKS ============
@@ -53,6 +70,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     if (key == GLFW_KEY_F2 && action == GLFW_PRESS)
         cullingEnabled = !cullingEnabled;
 
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        printStats = true;
+
     if (key >= 0 && key < 1024) {
         if (action == GLFW_PRESS) keys[key] = true;
         else if (action == GLFW_RELEASE) keys[key] = false;
@@ -80,6 +100,7 @@ void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
         if (playerInElevator) {
+            Elevator& elevator = elevators.Car(playerCar);
             int hitBtn = buttonPanel.Raycast(camera.Position, camera.Front, 3.0f);
             if (hitBtn >= 0) {
                 Button3D& btn = buttonPanel.buttons[hitBtn];
@@ -100,18 +121,21 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 }
 
 // ============ TEXTURE LOADING ============
-unsigned int loadAndSetupTexture(const char* path) {
-    unsigned int tex = loadImageToTexture(path);
-    if (tex != 0) {
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+// Layout of the decoded image list: 12 buttons, 8 floor labels, then student info
+const int BTN_IMAGE_FIRST = 0;
+const int FLOOR_IMAGE_FIRST = 12;
+const int STUDENT_INFO_IMAGE = 20;
+
+std::vector<std::string> textureImagePaths() {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 12; i++) {
+        paths.push_back("Resources/btn_" + std::to_string(i) + ".png");
     }
-    return tex;
+    for (int i = 0; i < 8; i++) {
+        paths.push_back("Resources/floor_" + std::to_string(i) + ".png");
+    }
+    paths.push_back("Resources/student_info.png");
+    return paths;
 }
 
 // ============ PLAYER MOVEMENT ============
@@ -131,40 +155,48 @@ void processPlayerMovement() {
         camera.Position.x = glm::clamp(camera.Position.x, -halfW, halfW);
         camera.Position.z = glm::clamp(camera.Position.z, -BUILDING_DEPTH + 0.3f, -0.3f);
 
-        // Check if near the elevator shaft area
-        bool nearShaftX = camera.Position.x > SHAFT_CENTER_X - elevHalfW - 0.15f &&
-                          camera.Position.x < SHAFT_CENTER_X + elevHalfW + 0.15f;
+        // Check if near one of the elevator shafts (or the wall between two)
         bool nearShaftZ = camera.Position.z < elevFrontZ + 0.15f;
-
-        if (nearShaftX && nearShaftZ) {
-            if (elevator.AreDoorsOpen() && elevator.IsAtFloor(playerFloor)) {
-                // Doors open and elevator is here - check if player walked inside
-                bool insideElev =
-                    camera.Position.x > SHAFT_CENTER_X - elevHalfW + 0.25f &&
-                    camera.Position.x < SHAFT_CENTER_X + elevHalfW - 0.25f &&
-                    camera.Position.z < elevFrontZ - 0.1f &&
-                    camera.Position.z > SHAFT_CENTER_Z - elevHalfD + 0.25f;
-                if (insideElev) {
-                    playerInElevator = true;
-                }
-            } else {
-                // Doors closed or elevator not here - block entry
-                camera.Position.z = elevFrontZ + 0.15f;
+        bool blocked = nearShaftZ;
+        for (int c = 0; c < NUM_CARS && nearShaftZ; c++) {
+            const Elevator& elevator = elevators.Car(c);
+            float carX = carShaftX(c);
+            bool nearShaftX = camera.Position.x > carX - elevHalfW - 0.15f &&
+                              camera.Position.x < carX + elevHalfW + 0.15f;
+            if (!nearShaftX || !elevator.AreDoorsOpen() || !elevator.IsAtFloor(playerFloor)) continue;
+
+            // Doors open and elevator is here - let the player through, and check if they walked inside
+            blocked = false;
+            bool insideElev =
+                camera.Position.x > carX - elevHalfW + 0.25f &&
+                camera.Position.x < carX + elevHalfW - 0.25f &&
+                camera.Position.z < elevFrontZ - 0.1f &&
+                camera.Position.z > SHAFT_CENTER_Z - elevHalfD + 0.25f;
+            if (insideElev) {
+                playerInElevator = true;
+                playerCar = c;
             }
+            break;
+        }
+        if (blocked) {
+            // Doors closed or no elevator here - block entry
+            camera.Position.z = elevFrontZ + 0.15f;
         }
 
-        // Call elevator with C key
+        // Call an elevator with C key; the group picks which car comes
         if (keys[GLFW_KEY_C]) {
-            elevator.CallToFloor(playerFloor);
+            elevators.CallToFloor(playerFloor);
             keys[GLFW_KEY_C] = false;
         }
 
         camera.Position.y = playerFloor * FLOOR_HEIGHT + PLAYER_HEIGHT;
     } else {
         // Inside elevator: constrain to cab bounds
+        const Elevator& elevator = elevators.Car(playerCar);
+        float carX = carShaftX(playerCar);
         camera.Position.x = glm::clamp(camera.Position.x,
-            SHAFT_CENTER_X - elevHalfW + 0.3f,
-            SHAFT_CENTER_X + elevHalfW - 0.3f);
+            carX - elevHalfW + 0.3f,
+            carX + elevHalfW - 0.3f);
 
         if (elevator.AreDoorsOpen()) {
             // Allow moving toward door to exit
@@ -191,27 +223,23 @@ void processPlayerMovement() {
 }
 
 // ============ DRAW TEXTURED QUAD 3D HELPER ============
-void drawTexturedQuad3D(unsigned int shader, const Mesh& box, unsigned int tex,
+void drawTexturedQuad3D(InstanceRenderer& renderer, const Mesh& box, unsigned int texArray, int layer,
                          glm::vec3 pos, glm::vec3 scale) {
-    glUniform1i(glGetUniformLocation(shader, "useTexture"), 1);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glUniform1i(glGetUniformLocation(shader, "diffuseTexture"), 0);
-
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, pos);
     model = glm::scale(model, scale);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(box.VAO);
-    glDrawElements(GL_TRIANGLES, box.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUniform1i(glGetUniformLocation(shader, "useTexture"), 0);
+    renderer.PushLayer(box, model, glm::vec3(1.0f), glm::vec4(0.0f), texArray, layer);
 }
 
 // ============ MAIN ============
 int main()
 {
+    auto startupBegin = std::chrono::steady_clock::now();
+
+    // Decode every PNG on worker threads while the window, context and shaders come up
+    std::future<std::vector<DecodedImage>> decodedImages =
+        std::async(std::launch::async, decodeImages, textureImagePaths());
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -237,53 +265,82 @@ int main()
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     // OpenGL state
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    stateSetEnabled(GL_DEPTH_TEST, true);
+    stateSetEnabled(GL_CULL_FACE, true);
+    stateSetEnabled(GL_BLEND, true);
+    stateBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Load shaders
-    unsigned int basicShader = createShader("Shaders/basic.vert", "Shaders/basic.frag");
-    unsigned int hudShader = createShader("Shaders/hud.vert", "Shaders/hud.frag");
+    BasicShader basicShader = createBasicShader("Shaders/basic.vert", "Shaders/basic.frag");
+    HudShader hudShader = createHudShader("Shaders/hud.vert", "Shaders/hud.frag");
 
     // Generate meshes
     Mesh quadMesh = createQuadMesh();
     Mesh boxMesh = createBoxMesh();
-    Mesh cylinderMesh = createCylinderMesh(16);
-    Mesh sphereMesh = createSphereMesh(12, 24);
-    Mesh coneMesh = createConeMesh(16);
+    LodMesh cylinderLods = createCylinderLods();
+    LodMesh sphereLods = createSphereLods();
+    LodMesh coneLods = createConeLods();
+    uploadMeshArena();
 
-    // Load textures
-    studentInfoTex = loadAndSetupTexture("Resources/student_info.png");
-    for (int i = 0; i < 12; i++) {
-        std::string path = "Resources/btn_" + std::to_string(i) + ".png";
-        btnTextures[i] = loadAndSetupTexture(path.c_str());
-    }
-    for (int i = 0; i < 8; i++) {
-        std::string path = "Resources/floor_" + std::to_string(i) + ".png";
-        floorTextures[i] = loadAndSetupTexture(path.c_str());
-    }
+    // Bake static walls, slabs and shaft into one buffer
+    building.BuildStaticGeometry();
+
+    // Upload textures (decoding ran in the background; waits only if it has not finished)
+    auto decodeWaitBegin = std::chrono::steady_clock::now();
+    std::vector<DecodedImage> images = decodedImages.get();
+    auto decodeWaitEnd = std::chrono::steady_clock::now();
+
+    btnTextureArray = createTextureArray(&images[BTN_IMAGE_FIRST], 12);
+    floorTextureArray = createTextureArray(&images[FLOOR_IMAGE_FIRST], 8);
+    studentInfoTex = uploadTexture2D(images[STUDENT_INFO_IMAGE]);
+    images.clear();
 
-    // Initialize button panel
+    visibilityTable.Build();
+
+    // Initialize button panel; positions first, so the glow lights start at the buttons
     buttonPanel.Init();
+    buttonPanel.UpdatePositions(carShaftX(playerCar), elevators.Car(playerCar).currentY);
 
     // Setup lights
+    lightManager.Init();
     for (int i = 0; i < NUM_FLOORS; i++) {
         lightManager.AddFloorLight(i);
     }
-    elevatorLightIdx = lightManager.AddElevatorLight(elevator.currentY);
+    for (int c = 0; c < NUM_CARS; c++) {
+        elevatorLightIdx[c] = lightManager.AddElevatorLight(carShaftX(c), elevators.Car(c).currentY);
+    }
+    for (size_t i = 0; i < buttonPanel.buttons.size(); i++) {
+        buttonPanel.buttons[i].glowLightIdx = lightManager.AddButtonGlow(buttonPanel.buttons[i].center);
+    }
+    lightClusters.Init();
 
     // Set default material properties
-    glUseProgram(basicShader);
-    glUniform3f(glGetUniformLocation(basicShader, "materialSpecular"), 0.3f, 0.3f, 0.3f);
-    glUniform1f(glGetUniformLocation(basicShader, "materialShininess"), 32.0f);
-    glUniform1f(glGetUniformLocation(basicShader, "alpha"), 1.0f);
-    glUniform3f(glGetUniformLocation(basicShader, "emissiveColor"), 0.0f, 0.0f, 0.0f);
-    glUniform1f(glGetUniformLocation(basicShader, "emissiveStrength"), 0.0f);
+    stateUseProgram(basicShader.id);
+    glUniform3f(basicShader.materialSpecular, 0.3f, 0.3f, 0.3f);
+    glUniform1f(basicShader.materialShininess, 32.0f);
+    glUniform1f(basicShader.alpha, 1.0f);
+    glUniform1i(basicShader.useTexture, 0);
+    glUniform1i(basicShader.diffuseTexture, 0);
+    glUniform1i(basicShader.clusterGrid, 1);
+    glUniform1i(basicShader.clusterLights, 2);
+    glUniform1i(basicShader.labelTextures, 3);
+
+    // Label arrays live on unit 3 in both shaders, apart from the 2D samplers on unit 0
+    stateUseProgram(hudShader.id);
+    glUniform1i(hudShader.uTextureArray, 3);
+    glUniform1i(hudShader.uLayer, -1);
+
+    instanceRenderer.Init(basicShader);
 
     lastX = screenWidth / 2.0f;
     lastY = screenHeight / 2.0f;
 
+    auto startupEnd = std::chrono::steady_clock::now();
+    std::cout << "Startup: "
+              << std::chrono::duration<double, std::milli>(startupEnd - startupBegin).count() << " ms"
+              << " (waited " << std::chrono::duration<double, std::milli>(decodeWaitEnd - decodeWaitBegin).count()
+              << " ms for texture decoding)" << std::endl;
+
     // ============ RENDER LOOP ============
     double lastTime = glfwGetTime();
 
@@ -305,10 +362,13 @@ int main()
         processPlayerMovement();
 
         // --- UPDATE ---
-        elevator.Update(deltaTime);
-        buttonPanel.UpdatePositions(elevator.currentY);
-        lightManager.UpdateLightPosition(elevatorLightIdx,
-            glm::vec3(SHAFT_CENTER_X, elevator.currentY + ELEVATOR_HEIGHT - 0.2f, SHAFT_CENTER_Z));
+        elevators.Update(deltaTime);
+        for (int c = 0; c < NUM_CARS; c++) {
+            lightManager.UpdateLightPosition(elevatorLightIdx[c],
+                glm::vec3(carShaftX(c), elevators.Car(c).currentY + ELEVATOR_HEIGHT - 0.2f, SHAFT_CENTER_Z));
+        }
+        const Elevator& elevator = elevators.Car(playerCar);
+        buttonPanel.UpdatePositions(carShaftX(playerCar), elevator.currentY);
 
         // Update button active states
         for (size_t i = 0; i < buttonPanel.buttons.size(); i++) {
@@ -322,101 +382,111 @@ int main()
             } else {
                 btn.active = false;
             }
+
+            // Lit buttons glow onto the panel
+            glm::vec3 glowPos = btn.center + btn.normal * 0.05f;
+            lightManager.UpdateLightPosition(btn.glowLightIdx, glowPos);
+            lightManager.SetLightActive(btn.glowLightIdx, btn.active);
         }
 
         // --- RENDER ---
+        beginStateFrame();
         glClearColor(0.02f, 0.02f, 0.05f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
-        else glDisable(GL_DEPTH_TEST);
-
-        if (cullingEnabled) glEnable(GL_CULL_FACE);
-        else glDisable(GL_CULL_FACE);
+        stateSetEnabled(GL_DEPTH_TEST, depthTestEnabled);
+        stateSetEnabled(GL_CULL_FACE, cullingEnabled);
 
         float aspect = (float)screenWidth / (float)screenHeight;
         glm::mat4 view = camera.GetViewMatrix();
         glm::mat4 projection = camera.GetProjectionMatrix(aspect);
 
-        glUseProgram(basicShader);
-        glUniformMatrix4fv(glGetUniformLocation(basicShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(basicShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3fv(glGetUniformLocation(basicShader, "viewPos"), 1, glm::value_ptr(camera.Position));
-        glUniform1f(glGetUniformLocation(basicShader, "alpha"), 1.0f);
-
-        // Upload lights
-        lightManager.UploadToShader(basicShader);
-
-        // Draw building (using boxMesh for walls)
-        building.DrawFloors(basicShader, quadMesh, boxMesh);
-        building.DrawElevatorShaft(basicShader, boxMesh);
-        building.DrawElevatorCab(basicShader, elevator.currentY, elevator.doorOpenAmount, boxMesh, quadMesh);
-        building.DrawLightFixtures(basicShader, elevator.currentY, cylinderMesh, sphereMesh, coneMesh);
-        building.DrawPlants(basicShader, cylinderMesh, sphereMesh, coneMesh);
-
-        // Draw button panel with textures
-        buttonPanel.Draw(basicShader, boxMesh, btnTextures);
-
-        // Draw floor indicator display inside elevator (on back wall)
-        {
-            int dispFloor = elevator.currentFloor;
-            if (dispFloor >= 0 && dispFloor < 8 && floorTextures[dispFloor] != 0) {
+        Frustum frustum;
+        frustum.Update(projection * view);
+        instanceRenderer.BeginFrame(&frustum, camera.Position, &lightManager);
+        lodSelector.BeginFrame(camera.Position, CAMERA_FOV, screenHeight);
+
+        stateUseProgram(basicShader.id);
+        glUniformMatrix4fv(basicShader.view, 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(basicShader.projection, 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform3fv(basicShader.viewPos, 1, glm::value_ptr(camera.Position));
+        glUniform1f(basicShader.alpha, 1.0f);
+
+        // Upload lights (no-op when nothing changed since last frame)
+        lightManager.Upload();
+
+        // Re-bin lights into clusters (no-op when neither lights nor camera moved)
+        lightClusters.Update(lightManager, view, projection);
+        lightClusters.Bind(basicShader, screenWidth, screenHeight);
+
+        // Only the player's floor (or the cab's, when riding) can be seen past the slabs
+        int visFloor = playerInElevator ? elevator.currentFloor : playerFloor;
+        const VisibleSet& visible = visibilityTable.Query(visFloor, playerInElevator, elevator.AreDoorsOpen());
+
+        // Draw building: baked static geometry, then the moving cabs and props
+        building.DrawStatic(instanceRenderer, visible);
+        building.DrawLightFixtures(instanceRenderer, visible, lodSelector, cylinderLods, coneLods);
+        building.DrawPlants(instanceRenderer, visible, lodSelector, cylinderLods, sphereLods, coneLods);
+
+        // The ridden cab follows visible.cab; the others are seen from the hallway
+        // or through open doors, so only when some floor room is
+        bool carVisible[NUM_CARS];
+        glm::vec3 bulbColor(1.0f, 0.95f, 0.8f);
+        for (int c = 0; c < NUM_CARS; c++) {
+            bool ridden = playerInElevator && c == playerCar;
+            carVisible[c] = ridden ? visible.cab : (visible.shaft || visible.firstFloor <= visible.lastFloor);
+            if (!carVisible[c]) continue;
+
+            const Elevator& car = elevators.Car(c);
+            float carX = carShaftX(c);
+            building.DrawElevatorCab(instanceRenderer, c, car.currentY, car.doorOpenAmount, boxMesh, quadMesh);
+            building.DrawCabFixture(instanceRenderer, c, car.currentY, lodSelector, cylinderLods, coneLods);
+
+            // Floor indicator display inside the cab (on back wall)
+            int dispFloor = car.currentFloor;
+            if (dispFloor >= 0 && dispFloor < 8 && floorTextureArray != 0) {
                 float elevHalfD = ELEVATOR_DEPTH / 2.0f;
                 glm::vec3 dispPos(
-                    SHAFT_CENTER_X,
-                    elevator.currentY + ELEVATOR_HEIGHT * 0.75f,
+                    carX,
+                    car.currentY + ELEVATOR_HEIGHT * 0.75f,
                     SHAFT_CENTER_Z - elevHalfD + 0.08f
                 );
-                drawTexturedQuad3D(basicShader, boxMesh, floorTextures[dispFloor],
+                drawTexturedQuad3D(instanceRenderer, boxMesh, floorTextureArray, dispFloor,
                     dispPos, glm::vec3(0.5f, 0.25f, 0.02f));
             }
+
+            // Cab bulb as an emissive sphere
+            float bulbY = car.currentY + ELEVATOR_HEIGHT - 0.28f;
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(carX, bulbY, SHAFT_CENTER_Z));
+            model = glm::scale(model, glm::vec3(0.06f, 0.06f, 0.06f));
+            const Mesh& sphere = lodSelector.Select(sphereLods, Building::LOD_OBJECTS + NUM_FLOORS + c, model);
+            instanceRenderer.Push(sphere, model, bulbColor, glm::vec4(bulbColor, 1.0f));
         }
 
-        // Draw light bulbs as emissive spheres
-        for (int i = 0; i < NUM_FLOORS; i++) {
+        // Draw button panel with textures
+        if (carVisible[playerCar])
+            buttonPanel.Draw(instanceRenderer, boxMesh, btnTextureArray);
+
+        // Draw floor light bulbs as emissive spheres
+        for (int i = visible.firstFloor; i <= visible.lastFloor; i++) {
             float bulbY = i * FLOOR_HEIGHT + FLOOR_HEIGHT - 0.35f;
-            glm::vec3 bulbColor(1.0f, 0.95f, 0.8f);
-            glUniform3fv(glGetUniformLocation(basicShader, "solidColor"), 1, glm::value_ptr(bulbColor));
-            glUniform1i(glGetUniformLocation(basicShader, "useTexture"), 0);
-            glUniform3fv(glGetUniformLocation(basicShader, "emissiveColor"), 1, glm::value_ptr(bulbColor));
-            glUniform1f(glGetUniformLocation(basicShader, "emissiveStrength"), 1.0f);
 
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(0.0f, bulbY, -BUILDING_DEPTH / 2.0f));
             model = glm::scale(model, glm::vec3(0.07f, 0.07f, 0.07f));
-            glUniformMatrix4fv(glGetUniformLocation(basicShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(sphereMesh.VAO);
-            glDrawElements(GL_TRIANGLES, sphereMesh.indexCount, GL_UNSIGNED_INT, 0);
+            const Mesh& sphere = lodSelector.Select(sphereLods, Building::LOD_OBJECTS + i, model);
+            instanceRenderer.Push(sphere, model, bulbColor, glm::vec4(bulbColor, 1.0f));
         }
-        // Elevator bulb
-        {
-            float bulbY = elevator.currentY + ELEVATOR_HEIGHT - 0.28f;
-            glm::vec3 bulbColor(1.0f, 0.95f, 0.8f);
-            glUniform3fv(glGetUniformLocation(basicShader, "solidColor"), 1, glm::value_ptr(bulbColor));
-            glUniform3fv(glGetUniformLocation(basicShader, "emissiveColor"), 1, glm::value_ptr(bulbColor));
-            glUniform1f(glGetUniformLocation(basicShader, "emissiveStrength"), 1.0f);
 
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(SHAFT_CENTER_X, bulbY, SHAFT_CENTER_Z));
-            model = glm::scale(model, glm::vec3(0.06f, 0.06f, 0.06f));
-            glUniformMatrix4fv(glGetUniformLocation(basicShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(sphereMesh.VAO);
-            glDrawElements(GL_TRIANGLES, sphereMesh.indexCount, GL_UNSIGNED_INT, 0);
-        }
-        // Reset emissive
-        {
-            glm::vec3 zero(0.0f);
-            glUniform3fv(glGetUniformLocation(basicShader, "emissiveColor"), 1, glm::value_ptr(zero));
-            glUniform1f(glGetUniformLocation(basicShader, "emissiveStrength"), 0.0f);
-        }
-
-        glBindVertexArray(0);
+        // Everything above was only queued; draw it sorted, then the HUD on top
+        instanceRenderer.Flush();
 
         // ============ HUD OVERLAY ============
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
+        stateSetEnabled(GL_DEPTH_TEST, false);
+        stateSetEnabled(GL_CULL_FACE, false);
 
-        glUseProgram(hudShader);
+        stateUseProgram(hudShader.id);
 
         // Crosshair
         {
@@ -425,9 +495,9 @@ int main()
                 : glm::vec3(1.0f, 1.0f, 1.0f);
             float crossAlpha = elevator.ventilationColorActive ? 1.0f : 0.7f;
 
-            glUniform1i(glGetUniformLocation(hudShader, "uIsTexture"), 0);
-            glUniform3fv(glGetUniformLocation(hudShader, "uColor"), 1, glm::value_ptr(crossColor));
-            glUniform1f(glGetUniformLocation(hudShader, "uAlpha"), crossAlpha);
+            glUniform1i(hudShader.uIsTexture, 0);
+            glUniform3fv(hudShader.uColor, 1, glm::value_ptr(crossColor));
+            glUniform1f(hudShader.uAlpha, crossAlpha);
 
             float crossSize = 0.018f;
             float crossThick = 0.003f;
@@ -435,114 +505,121 @@ int main()
             // Horizontal
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::scale(model, glm::vec3(crossSize * 2.0f, crossThick * 2.0f, 1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(quadMesh.VAO);
-            glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
+            glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+            stateBindVertexArray(getMeshArenaVAO());
+            drawMeshElements(quadMesh);
 
             // Vertical
             model = glm::mat4(1.0f);
             model = glm::scale(model, glm::vec3(crossThick * 2.0f, crossSize * 2.0f, 1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
+            glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+            drawMeshElements(quadMesh);
         }
 
         // Aimed button highlight
         if (playerInElevator) {
             int aimed = buttonPanel.Raycast(camera.Position, camera.Front, 3.0f);
             if (aimed >= 0) {
-                glUniform1i(glGetUniformLocation(hudShader, "uIsTexture"), 0);
-                glUniform3f(glGetUniformLocation(hudShader, "uColor"), 1.0f, 1.0f, 0.0f);
-                glUniform1f(glGetUniformLocation(hudShader, "uAlpha"), 0.3f);
+                glUniform1i(hudShader.uIsTexture, 0);
+                glUniform3f(hudShader.uColor, 1.0f, 1.0f, 0.0f);
+                glUniform1f(hudShader.uAlpha, 0.3f);
 
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::scale(model, glm::vec3(0.05f, 0.05f, 1.0f));
-                glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-                glBindVertexArray(quadMesh.VAO);
-                glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
+                glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+                stateBindVertexArray(getMeshArenaVAO());
+                drawMeshElements(quadMesh);
             }
         }
 
         // Student info texture (bottom-right, semi-transparent)
         if (studentInfoTex != 0) {
-            glUniform1i(glGetUniformLocation(hudShader, "uIsTexture"), 1);
-            glUniform1f(glGetUniformLocation(hudShader, "uAlpha"), 0.6f);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, studentInfoTex);
-            glUniform1i(glGetUniformLocation(hudShader, "uTexture"), 0);
+            glUniform1i(hudShader.uIsTexture, 1);
+            glUniform1f(hudShader.uAlpha, 0.6f);
+            stateBindTexture(0, GL_TEXTURE_2D, studentInfoTex);
+            glUniform1i(hudShader.uTexture, 0);
 
             float infoW = 0.3f;
             float infoH = 0.06f;
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(1.0f - infoW, -1.0f + infoH, 0.0f));
             model = glm::scale(model, glm::vec3(infoW * 2.0f, infoH * 2.0f, 1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(quadMesh.VAO);
-            glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+            stateBindVertexArray(getMeshArenaVAO());
+            drawMeshElements(quadMesh);
         }
 
         // Floor indicator HUD (top-left corner)
         {
             int dispFloor = playerInElevator ? elevator.currentFloor : playerFloor;
-            if (dispFloor >= 0 && dispFloor < 8 && floorTextures[dispFloor] != 0) {
-                glUniform1i(glGetUniformLocation(hudShader, "uIsTexture"), 1);
-                glUniform1f(glGetUniformLocation(hudShader, "uAlpha"), 0.85f);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, floorTextures[dispFloor]);
-                glUniform1i(glGetUniformLocation(hudShader, "uTexture"), 0);
+            if (dispFloor >= 0 && dispFloor < 8 && floorTextureArray != 0) {
+                glUniform1i(hudShader.uIsTexture, 1);
+                glUniform1f(hudShader.uAlpha, 0.85f);
+                stateBindTexture(3, GL_TEXTURE_2D_ARRAY, floorTextureArray);
+                glUniform1i(hudShader.uLayer, dispFloor);
 
                 float w = 0.08f;
                 float h = 0.05f;
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, glm::vec3(-1.0f + w + 0.02f, 1.0f - h - 0.02f, 0.0f));
                 model = glm::scale(model, glm::vec3(w * 2.0f, h * 2.0f, 1.0f));
-                glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-                glBindVertexArray(quadMesh.VAO);
-                glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
-                glBindTexture(GL_TEXTURE_2D, 0);
+                glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+                stateBindVertexArray(getMeshArenaVAO());
+                drawMeshElements(quadMesh);
+                glUniform1i(hudShader.uLayer, -1);
             }
         }
 
         // Status indicator: blue bar = in elevator, green bar = on floor
         {
-            glUniform1i(glGetUniformLocation(hudShader, "uIsTexture"), 0);
+            glUniform1i(hudShader.uIsTexture, 0);
             if (playerInElevator) {
-                glUniform3f(glGetUniformLocation(hudShader, "uColor"), 0.2f, 0.4f, 0.9f);
+                glUniform3f(hudShader.uColor, 0.2f, 0.4f, 0.9f);
             } else {
-                glUniform3f(glGetUniformLocation(hudShader, "uColor"), 0.2f, 0.8f, 0.3f);
+                glUniform3f(hudShader.uColor, 0.2f, 0.8f, 0.3f);
             }
-            glUniform1f(glGetUniformLocation(hudShader, "uAlpha"), 0.6f);
+            glUniform1f(hudShader.uAlpha, 0.6f);
 
             float barW = 0.005f;
             float barH = 0.04f;
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(-1.0f + 0.005f, 1.0f - 0.05f, 0.0f));
             model = glm::scale(model, glm::vec3(barW * 2.0f, barH * 2.0f, 1.0f));
-            glUniformMatrix4fv(glGetUniformLocation(hudShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(quadMesh.VAO);
-            glDrawElements(GL_TRIANGLES, quadMesh.indexCount, GL_UNSIGNED_INT, 0);
+            glUniformMatrix4fv(hudShader.model, 1, GL_FALSE, glm::value_ptr(model));
+            stateBindVertexArray(getMeshArenaVAO());
+            drawMeshElements(quadMesh);
         }
 
-        glBindVertexArray(0);
-
-        // Restore state
-        if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
-        if (cullingEnabled) glEnable(GL_CULL_FACE);
+        // Depth test and culling are set again at the top of the next frame
+
+        if (printStats) {
+            const RenderStats& stats = instanceRenderer.Stats();
+            std::cout << "Objects visible: " << stats.objectsVisible
+                      << ", culled: " << stats.objectsCulled
+                      << ", draw calls: " << stats.drawCalls
+                      << ", instances: " << stats.instances
+                      << ", triangles: " << stats.triangles
+                      << ", own light lists: " << stats.lightListed << std::endl;
+            const GLStateStats& glStats = getStateStats();
+            std::cout << "GL state changes issued: " << glStats.issued
+                      << ", filtered: " << glStats.filtered << std::endl;
+            printStats = false;
+        }
 
         glfwSwapBuffers(window);
     }
 
     // Cleanup
-    deleteMesh(quadMesh);
-    deleteMesh(boxMesh);
-    deleteMesh(cylinderMesh);
-    deleteMesh(sphereMesh);
-    deleteMesh(coneMesh);
+    deleteMeshArena();
+    building.DestroyStaticGeometry();
     if (studentInfoTex) glDeleteTextures(1, &studentInfoTex);
-    for (int i = 0; i < 12; i++) if (btnTextures[i]) glDeleteTextures(1, &btnTextures[i]);
-    for (int i = 0; i < 8; i++) if (floorTextures[i]) glDeleteTextures(1, &floorTextures[i]);
-    glDeleteProgram(basicShader);
-    glDeleteProgram(hudShader);
+    if (btnTextureArray) glDeleteTextures(1, &btnTextureArray);
+    if (floorTextureArray) glDeleteTextures(1, &floorTextureArray);
+    lightManager.Destroy();
+    lightClusters.Destroy();
+    instanceRenderer.Destroy();
+    glDeleteProgram(basicShader.id);
+    glDeleteProgram(hudShader.id);
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
@@ -1,47 +1,316 @@
 #include "../Header/Mesh.h"
+#include "../Header/Constants.h"
+#include "../Header/GLState.h"
+#include <glm/gtc/packing.hpp>
 #include <vector>
 #include <cmath>
+#include <cstddef>
+#include <iostream>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-static Mesh buildMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+// Every primitive lives in one shared vertex/index arena. createXMesh appends
+// on the CPU side; uploadMeshArena creates the single VAO/VBO/EBO afterwards.
+// Vertices are raw bytes in the arena's format; the index buffer mixes 16- and
+// 32-bit meshes, each aligned to its own index size.
+static std::vector<unsigned char> arenaVertices;
+static std::vector<unsigned char> arenaIndices;
+static int arenaVertexCount = 0;
+static unsigned int arenaVAO = 0, arenaVBO = 0, arenaEBO = 0;
+
+// Packed arena vertex (COMPACT_MESH_VERTICES)
+struct CompactVertex {
+    float position[3];
+    glm::uint32 normal;   // GL_INT_2_10_10_10_REV, xyz in signed normalized 10 bits
+    glm::uint32 texCoord; // two halves
+};
+static_assert(sizeof(CompactVertex) == 20, "CompactVertex must stay 20 bytes");
+
+static const size_t VERTEX_STRIDE = COMPACT_MESH_VERTICES ? sizeof(CompactVertex) : 8 * sizeof(float);
+
+template <typename T>
+static void appendBytes(std::vector<unsigned char>& out, const T* data, size_t count) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+// ============ VERTEX CACHE OPTIMIZATION ============
+// Forsyth, "Linear-Speed Vertex Cache Optimisation": greedily emit the triangle
+// whose vertices score best for a simulated LRU cache, then renumber vertices
+// in first-use order so fetches walk the vertex buffer forwards.
+
+static const int VCACHE_SIZE = 32;     // LRU cache simulated while reordering
+static const int ACMR_FIFO_SIZE = 16;  // FIFO post-transform cache used for reporting
+
+static float vertexScore(int cachePosition, int remainingTris) {
+    if (remainingTris == 0) return -1.0f; // nothing left to gain from this vertex
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = 0.75f; // part of the last triangle: fixed, so it is not reused at once
+        } else {
+            float scaler = 1.0f / (VCACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scaler, 1.5f);
+        }
+    }
+    // Favour vertices with few triangles left, so they get finished off
+    score += 2.0f / sqrtf((float)remainingTris);
+    return score;
+}
+
+// Average cache miss ratio: transformed vertices per triangle for a FIFO cache
+static float computeACMR(const std::vector<unsigned int>& indices, int vertexCount) {
+    if (indices.empty()) return 0.0f;
+
+    std::vector<int> insertedAt(vertexCount, -ACMR_FIFO_SIZE - 1);
+    int misses = 0;
+    for (unsigned int index : indices) {
+        if (misses - insertedAt[index] > ACMR_FIFO_SIZE) {
+            insertedAt[index] = misses;
+            misses++;
+        }
+    }
+    return (float)misses / (float)(indices.size() / 3);
+}
+
+static void optimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount) {
+    int triCount = (int)(indices.size() / 3);
+    if (triCount == 0) return;
+
+    // Triangles using each vertex, as a flat adjacency list
+    std::vector<int> remaining(vertexCount, 0), adjStart(vertexCount + 1, 0);
+    for (unsigned int index : indices) remaining[index]++;
+    for (int v = 0; v < vertexCount; v++) adjStart[v + 1] = adjStart[v] + remaining[v];
+    std::vector<int> adjacency(indices.size()), adjFill(adjStart.begin(), adjStart.end() - 1);
+    for (int t = 0; t < triCount; t++)
+        for (int k = 0; k < 3; k++)
+            adjacency[adjFill[indices[t * 3 + k]]++] = t;
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (int v = 0; v < vertexCount; v++) vScore[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> tScore(triCount);
+    std::vector<bool> emitted(triCount, false);
+    for (int t = 0; t < triCount; t++)
+        tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    std::vector<int> cache; // most recent first, may grow to VCACHE_SIZE + 3 before trimming
+
+    int best = 0;
+    for (int t = 1; t < triCount; t++)
+        if (tScore[t] > tScore[best]) best = t;
+
+    int nextScan = 0;
+    for (int emittedCount = 0; emittedCount < triCount; emittedCount++) {
+        if (best < 0) {
+            // Nothing in the cache touches a remaining triangle: take the next unemitted one
+            while (emitted[nextScan]) nextScan++;
+            best = nextScan;
+        }
+
+        emitted[best] = true;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[best * 3 + k];
+            result.push_back(v);
+
+            // Retire this triangle from the vertex's adjacency
+            int begin = adjStart[v], end = begin + remaining[v];
+            for (int a = begin; a < end; a++) {
+                if (adjacency[a] == best) {
+                    adjacency[a] = adjacency[end - 1];
+                    break;
+                }
+            }
+            remaining[v]--;
+
+            // Move to the front of the LRU cache
+            for (size_t c = 0; c < cache.size(); c++) {
+                if (cache[c] == (int)v) {
+                    cache.erase(cache.begin() + c);
+                    break;
+                }
+            }
+            cache.insert(cache.begin(), (int)v);
+        }
+
+        // Vertices pushed out of the cache lose their cache bonus
+        while ((int)cache.size() > VCACHE_SIZE) {
+            int v = cache.back();
+            cache.pop_back();
+            cachePos[v] = -1;
+            float score = vertexScore(-1, remaining[v]);
+            for (int a = adjStart[v]; a < adjStart[v] + remaining[v]; a++)
+                tScore[adjacency[a]] += score - vScore[v];
+            vScore[v] = score;
+        }
+
+        // Rescore what is in the cache and pick the best triangle among its neighbours
+        best = -1;
+        float bestScore = -1.0f;
+        for (size_t c = 0; c < cache.size(); c++) {
+            int v = cache[c];
+            cachePos[v] = (int)c;
+            float score = vertexScore((int)c, remaining[v]);
+            for (int a = adjStart[v]; a < adjStart[v] + remaining[v]; a++)
+                tScore[adjacency[a]] += score - vScore[v];
+            vScore[v] = score;
+        }
+        for (size_t c = 0; c < cache.size(); c++) {
+            int v = cache[c];
+            for (int a = adjStart[v]; a < adjStart[v] + remaining[v]; a++) {
+                int t = adjacency[a];
+                if (tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+// Renumbers vertices in the order the indices first use them (unused ones go last)
+static void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    int vertexCount = (int)(vertices.size() / 8);
+    std::vector<int> remap(vertexCount, -1);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+
+    int next = 0;
+    for (unsigned int& index : indices) {
+        if (remap[index] < 0) {
+            remap[index] = next++;
+            reordered.insert(reordered.end(), vertices.begin() + index * 8, vertices.begin() + index * 8 + 8);
+        }
+        index = (unsigned int)remap[index];
+    }
+    for (int v = 0; v < vertexCount; v++) {
+        if (remap[v] < 0)
+            reordered.insert(reordered.end(), vertices.begin() + v * 8, vertices.begin() + v * 8 + 8);
+    }
+    vertices.swap(reordered);
+}
+
+// Reorders for the post-transform cache, then for fetch locality, and reports the ACMR change
+static void optimizeMesh(const char* name, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    int vertexCount = (int)(vertices.size() / 8);
+    float before = computeACMR(indices, vertexCount);
+    optimizeVertexCache(indices, vertexCount);
+    optimizeVertexFetch(vertices, indices);
+    float after = computeACMR(indices, vertexCount);
+
+    std::cout << "Mesh " << name << ": " << indices.size() / 3 << " triangles, ACMR "
+              << before << " -> " << after << std::endl;
+}
+
+// Optimizes the mesh in place, then appends it to the arena
+static Mesh buildMesh(const char* name, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    optimizeMesh(name, vertices, indices);
+
+    int vertexCount = (int)(vertices.size() / 8);
+
     Mesh mesh;
+    mesh.baseVertex = arenaVertexCount;
     mesh.indexCount = (int)indices.size();
+    mesh.indexType = vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 
-    glGenVertexArrays(1, &mesh.VAO);
-    glGenBuffers(1, &mesh.VBO);
-    glGenBuffers(1, &mesh.EBO);
+    mesh.bounds.min = glm::vec3(vertices[0], vertices[1], vertices[2]);
+    mesh.bounds.max = mesh.bounds.min;
+    for (size_t i = 0; i < vertices.size(); i += 8) {
+        glm::vec3 p(vertices[i], vertices[i + 1], vertices[i + 2]);
+        mesh.bounds.min = glm::min(mesh.bounds.min, p);
+        mesh.bounds.max = glm::max(mesh.bounds.max, p);
+    }
+
+    if (COMPACT_MESH_VERTICES) {
+        std::vector<CompactVertex> packed(vertexCount);
+        for (int v = 0; v < vertexCount; v++) {
+            const float* src = &vertices[v * 8];
+            CompactVertex& dst = packed[v];
+            dst.position[0] = src[0];
+            dst.position[1] = src[1];
+            dst.position[2] = src[2];
+            dst.normal = glm::packSnorm3x10_1x2(glm::vec4(glm::normalize(glm::vec3(src[3], src[4], src[5])), 0.0f));
+            dst.texCoord = glm::packHalf2x16(glm::vec2(src[6], src[7]));
+        }
+        appendBytes(arenaVertices, packed.data(), packed.size());
+    } else {
+        appendBytes(arenaVertices, vertices.data(), vertices.size());
+    }
+    arenaVertexCount += vertexCount;
+
+    // Indices stay local to the mesh; baseVertex offsets them at draw time
+    if (mesh.indexType == GL_UNSIGNED_SHORT) {
+        std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+        mesh.firstIndex = (int)(arenaIndices.size() / sizeof(unsigned short));
+        appendBytes(arenaIndices, shortIndices.data(), shortIndices.size());
+    } else {
+        arenaIndices.resize((arenaIndices.size() + 3) & ~(size_t)3); // 4-byte alignment
+        mesh.firstIndex = (int)(arenaIndices.size() / sizeof(unsigned int));
+        appendBytes(arenaIndices, indices.data(), indices.size());
+    }
+    return mesh;
+}
 
-    glBindVertexArray(mesh.VAO);
+void uploadMeshArena() {
+    if (arenaVAO == 0) {
+        glGenVertexArrays(1, &arenaVAO);
+        glGenBuffers(1, &arenaVBO);
+        glGenBuffers(1, &arenaEBO);
+    }
+
+    stateBindVertexArray(arenaVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, arenaVBO);
+    glBufferData(GL_ARRAY_BUFFER, arenaVertices.size(), arenaVertices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arenaEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, arenaIndices.size(), arenaIndices.data(), GL_STATIC_DRAW);
 
-    // position (location 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    GLsizei stride = (GLsizei)VERTEX_STRIDE;
+    if (COMPACT_MESH_VERTICES) {
+        // position (location 0)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, position));
+        // normal (location 1), w is ignored by the vec3 input
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(CompactVertex, normal));
+        // texcoord (location 2)
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, texCoord));
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    }
     glEnableVertexAttribArray(0);
-    // normal (location 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
-    // texcoord (location 2)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
-    return mesh;
+    stateBindVertexArray(0);
+}
+
+unsigned int getMeshArenaVAO() {
+    return arenaVAO;
+}
+
+void deleteMeshArena() {
+    glDeleteVertexArrays(1, &arenaVAO);
+    glDeleteBuffers(1, &arenaVBO);
+    glDeleteBuffers(1, &arenaEBO);
+    arenaVAO = arenaVBO = arenaEBO = 0;
+    arenaVertices.clear();
+    arenaIndices.clear();
+    arenaVertexCount = 0;
 }
 
-void deleteMesh(Mesh& mesh) {
-    glDeleteVertexArrays(1, &mesh.VAO);
-    glDeleteBuffers(1, &mesh.VBO);
-    glDeleteBuffers(1, &mesh.EBO);
-    mesh.VAO = mesh.VBO = mesh.EBO = 0;
-    mesh.indexCount = 0;
+void drawMeshElements(const Mesh& mesh) {
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexCount, mesh.indexType,
+        meshIndexOffset(mesh), mesh.baseVertex);
 }
 
 Mesh createQuadMesh() {
@@ -54,7 +323,7 @@ Mesh createQuadMesh() {
         -0.5f, 0.0f,  0.5f,  0.0f, 1.0f, 0.0f,  0.0f, 1.0f,
     };
     std::vector<unsigned int> indices = { 0, 1, 2, 0, 2, 3 };
-    return buildMesh(vertices, indices);
+    return buildMesh("quad", vertices, indices);
 }
 
 Mesh createBoxMesh() {
@@ -102,7 +371,7 @@ Mesh createBoxMesh() {
         indices.push_back(base + 2);
         indices.push_back(base + 3);
     }
-    return buildMesh(vertices, indices);
+    return buildMesh("box", vertices, indices);
 }
 
 Mesh createCylinderMesh(int segments) {
@@ -154,7 +423,7 @@ Mesh createCylinderMesh(int segments) {
         indices.insert(indices.end(), { botCenter, botCenter + 2 + i, botCenter + 1 + i });
     }
 
-    return buildMesh(vertices, indices);
+    return buildMesh("cylinder", vertices, indices);
 }
 
 Mesh createSphereMesh(int rings, int segments) {
@@ -183,7 +452,7 @@ Mesh createSphereMesh(int rings, int segments) {
         }
     }
 
-    return buildMesh(vertices, indices);
+    return buildMesh("sphere", vertices, indices);
 }
 
 Mesh createConeMesh(int segments) {
@@ -225,5 +494,5 @@ Mesh createConeMesh(int segments) {
         indices.insert(indices.end(), { botCenter, botCenter + 2 + (unsigned int)i, botCenter + 1 + (unsigned int)i });
     }
 
-    return buildMesh(vertices, indices);
+    return buildMesh("cone", vertices, indices);
 }
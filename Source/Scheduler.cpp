@@ -0,0 +1,121 @@
+#include "../Header/Scheduler.h"
+#include <cmath>
+
+// Floors closer than this to the cab count as "here" rather than ahead or behind
+static const float AT_FLOOR = 0.01f;
+
+// Nearest request strictly above (dir +1) or below (dir -1) position, -1 if none
+static int nearestAhead(const std::vector<bool>& requests, float position, int dir) {
+    int count = (int)requests.size();
+    if (dir > 0) {
+        for (int f = 0; f < count; f++)
+            if (requests[f] && f > position + AT_FLOOR) return f;
+    } else {
+        for (int f = count - 1; f >= 0; f--)
+            if (requests[f] && f < position - AT_FLOOR) return f;
+    }
+    return -1;
+}
+
+static int requestHere(const std::vector<bool>& requests, float position) {
+    int f = (int)floor(position + 0.5f);
+    if (f >= 0 && f < (int)requests.size() && requests[f] && fabs(position - f) <= AT_FLOOR)
+        return f;
+    return -1;
+}
+
+static int headingTo(int floorIndex, float position, int direction) {
+    if (floorIndex > position + AT_FLOOR) return 1;
+    if (floorIndex < position - AT_FLOOR) return -1;
+    return direction;
+}
+
+class LowestScheduler : public Scheduler {
+public:
+    const char* Name() const { return "lowest"; }
+    int NextFloor(const std::vector<bool>& requests, float position, int& direction) const {
+        for (int f = 0; f < (int)requests.size(); f++) {
+            if (requests[f]) {
+                direction = headingTo(f, position, direction);
+                return f;
+            }
+        }
+        direction = 0;
+        return -1;
+    }
+};
+
+// Nearest first; ties go the way the cab is already heading
+class NearestScheduler : public Scheduler {
+public:
+    const char* Name() const { return "nearest"; }
+    int NextFloor(const std::vector<bool>& requests, float position, int& direction) const {
+        int here = requestHere(requests, position);
+        if (here >= 0) return here;
+
+        int up = nearestAhead(requests, position, 1);
+        int down = nearestAhead(requests, position, -1);
+        int best;
+        if (up < 0) best = down;
+        else if (down < 0) best = up;
+        else {
+            float du = up - position, dd = position - down;
+            if (fabs(du - dd) <= AT_FLOOR) best = direction < 0 ? down : up;
+            else best = du < dd ? up : down;
+        }
+        direction = best < 0 ? 0 : headingTo(best, position, direction);
+        return best;
+    }
+};
+
+// LOOK, or SCAN when toEnd is set: sweep in one direction serving requests in
+// passing, and turn around after the last one (LOOK) or at the end of the shaft (SCAN)
+class SweepScheduler : public Scheduler {
+public:
+    explicit SweepScheduler(bool toEnd) : toEnd(toEnd) {}
+
+    const char* Name() const { return toEnd ? "scan" : "look"; }
+
+    int NextFloor(const std::vector<bool>& requests, float position, int& direction) const {
+        int here = requestHere(requests, position);
+        if (here >= 0) return here;
+
+        int dir = direction != 0 ? direction : 1;
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int ahead = nearestAhead(requests, position, dir);
+            if (ahead >= 0) {
+                direction = dir;
+                return ahead;
+            }
+            int behind = nearestAhead(requests, position, -dir);
+            if (behind < 0) break;
+
+            // Requests only behind: SCAN first finishes the sweep at the last floor
+            int end = dir > 0 ? (int)requests.size() - 1 : 0;
+            if (toEnd && direction != 0 && fabs(position - end) > AT_FLOOR) {
+                direction = dir;
+                return end;
+            }
+            dir = -dir;
+        }
+        direction = 0;
+        return -1;
+    }
+
+private:
+    bool toEnd;
+};
+
+const Scheduler* getScheduler(SchedulingPolicy policy) {
+    static const LowestScheduler lowest;
+    static const SweepScheduler look(false);
+    static const SweepScheduler scan(true);
+    static const NearestScheduler nearest;
+
+    switch (policy) {
+    case SCHEDULE_LOWEST: return &lowest;
+    case SCHEDULE_SCAN: return &scan;
+    case SCHEDULE_NEAREST: return &nearest;
+    default: return &look;
+    }
+}
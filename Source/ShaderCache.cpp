@@ -0,0 +1,147 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/ShaderCache.h"
+#include "../Header/Util.h"
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+static const uint32_t CACHE_MAGIC = 0x31425053; // "SPB1"
+
+// Header in front of the driver's blob
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t format; // binaryFormat from glGetProgramBinary
+    uint64_t key;
+    uint32_t length;
+};
+
+static std::string readFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    if (file.is_open()) ss << file.rdbuf();
+    return ss.str();
+}
+
+// FNV-1a, chained over several strings
+static uint64_t hashString(uint64_t h, const std::string& s) {
+    for (size_t i = 0; i < s.size(); i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ull;
+    }
+    // Separator so "ab" + "c" differs from "a" + "bc"
+    h ^= 0xFF;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? std::string((const char*)s) : std::string();
+}
+
+// Directory of the running executable, with trailing separator ("" = working directory)
+static std::string executableDir() {
+#ifdef _WIN32
+    char path[MAX_PATH];
+    DWORD len = GetModuleFileNameA(NULL, path, MAX_PATH);
+    if (len == 0 || len == MAX_PATH) return "";
+    std::string dir(path, len);
+#else
+    std::string dir = "";
+#endif
+    size_t slash = dir.find_last_of("\\/");
+    return slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+}
+
+// "Shaders/basic.vert" -> "<exe dir>basic.progbin"
+static std::string cachePath(const char* vsSource) {
+    std::string name(vsSource);
+    size_t slash = name.find_last_of("\\/");
+    if (slash != std::string::npos) name = name.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos) name = name.substr(0, dot);
+    return executableDir() + name + ".progbin";
+}
+
+static unsigned int loadCached(const std::string& path, uint64_t key) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == NULL) return 0;
+
+    CacheHeader header;
+    std::vector<char> blob;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+              header.magic == CACHE_MAGIC && header.key == key && header.length > 0;
+    if (ok) {
+        blob.resize(header.length);
+        ok = fread(blob.data(), 1, blob.size(), f) == blob.size();
+    }
+    fclose(f);
+    if (!ok) return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.format, blob.data(), (GLsizei)blob.size());
+
+    // Drivers reject binaries after an update even with the same version string
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void saveCached(const std::string& path, uint64_t key, unsigned int program) {
+    int success, length;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (success == GL_FALSE || length <= 0) return;
+
+    std::vector<char> blob(length);
+    GLenum format;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, blob.data());
+    if (written <= 0) return;
+
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.format = format;
+    header.key = key;
+    header.length = (uint32_t)written;
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == NULL) return;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(blob.data(), 1, written, f) == (size_t)written;
+    fclose(f);
+    if (!ok) remove(path.c_str()); // never leave a truncated file behind
+}
+
+unsigned int createShaderCached(const char* vsSource, const char* fsSource) {
+    if (!GLEW_ARB_get_program_binary)
+        return createShader(vsSource, fsSource);
+
+    uint64_t key = 14695981039346656037ull;
+    key = hashString(key, readFile(vsSource));
+    key = hashString(key, readFile(fsSource));
+    key = hashString(key, glString(GL_VENDOR));
+    key = hashString(key, glString(GL_RENDERER));
+    key = hashString(key, glString(GL_VERSION));
+
+    std::string path = cachePath(vsSource);
+    unsigned int program = loadCached(path, key);
+    if (program != 0) return program;
+
+    program = createShader(vsSource, fsSource);
+    saveCached(path, key, program);
+    return program;
+}
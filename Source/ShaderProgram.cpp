@@ -0,0 +1,44 @@
+#include "../Header/ShaderProgram.h"
+#include "../Header/ShaderCache.h"
+#include "../Header/Constants.h"
+
+BasicShader createBasicShader(const char* vsSource, const char* fsSource) {
+    BasicShader s;
+    s.id = createShaderCached(vsSource, fsSource);
+
+    s.view = glGetUniformLocation(s.id, "view");
+    s.projection = glGetUniformLocation(s.id, "projection");
+
+    s.useTexture = glGetUniformLocation(s.id, "useTexture");
+    s.diffuseTexture = glGetUniformLocation(s.id, "diffuseTexture");
+    s.labelTextures = glGetUniformLocation(s.id, "labelTextures");
+    s.materialSpecular = glGetUniformLocation(s.id, "materialSpecular");
+    s.materialShininess = glGetUniformLocation(s.id, "materialShininess");
+    s.alpha = glGetUniformLocation(s.id, "alpha");
+    s.viewPos = glGetUniformLocation(s.id, "viewPos");
+
+    s.clusterGrid = glGetUniformLocation(s.id, "clusterGrid");
+    s.clusterLights = glGetUniformLocation(s.id, "clusterLights");
+    s.clusterTileScale = glGetUniformLocation(s.id, "clusterTileScale");
+    s.clusterSliceScale = glGetUniformLocation(s.id, "clusterSliceScale");
+    s.clusterSliceBias = glGetUniformLocation(s.id, "clusterSliceBias");
+
+    unsigned int lightBlock = glGetUniformBlockIndex(s.id, "LightBlock");
+    if (lightBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(s.id, lightBlock, LIGHT_BLOCK_BINDING);
+    return s;
+}
+
+HudShader createHudShader(const char* vsSource, const char* fsSource) {
+    HudShader s;
+    s.id = createShaderCached(vsSource, fsSource);
+
+    s.model = glGetUniformLocation(s.id, "model");
+    s.uTexture = glGetUniformLocation(s.id, "uTexture");
+    s.uTextureArray = glGetUniformLocation(s.id, "uTextureArray");
+    s.uLayer = glGetUniformLocation(s.id, "uLayer");
+    s.uAlpha = glGetUniformLocation(s.id, "uAlpha");
+    s.uIsTexture = glGetUniformLocation(s.id, "uIsTexture");
+    s.uColor = glGetUniformLocation(s.id, "uColor");
+    return s;
+}
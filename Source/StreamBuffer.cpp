@@ -0,0 +1,64 @@
+#include "../Header/StreamBuffer.h"
+
+StreamBuffer::StreamBuffer()
+    : buffer(0), target(GL_ARRAY_BUFFER), regionSize(0), region(0)
+{
+    for (int r = 0; r < REGIONS; r++)
+        fences[r] = 0;
+}
+
+void StreamBuffer::Init(GLenum bufferTarget) {
+    target = bufferTarget;
+    glGenBuffers(1, &buffer);
+}
+
+void StreamBuffer::Destroy() {
+    for (int r = 0; r < REGIONS; r++) {
+        if (fences[r]) glDeleteSync(fences[r]);
+        fences[r] = 0;
+    }
+    if (buffer) glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    regionSize = 0;
+    region = 0;
+}
+
+// Blocks until the GPU has finished the draws that last read region r
+void StreamBuffer::waitFor(int r) {
+    if (!fences[r]) return;
+    GLenum result = glClientWaitSync(fences[r], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    while (result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fences[r], 0, 1000000000);
+    glDeleteSync(fences[r]);
+    fences[r] = 0;
+}
+
+void* StreamBuffer::Map(size_t bytes) {
+    glBindBuffer(target, buffer);
+
+    if (bytes > regionSize) {
+        // New storage: nothing in flight can touch it, so the fences are moot
+        for (int r = 0; r < REGIONS; r++) {
+            if (fences[r]) glDeleteSync(fences[r]);
+            fences[r] = 0;
+        }
+        regionSize = bytes * 2;
+        region = 0;
+        glBufferData(target, regionSize * REGIONS, NULL, GL_STREAM_DRAW);
+    }
+
+    waitFor(region);
+    return glMapBufferRange(target, RegionOffset(), bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::Unmap() {
+    glBindBuffer(target, buffer);
+    glUnmapBuffer(target);
+}
+
+void StreamBuffer::Advance() {
+    if (fences[region]) glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % REGIONS;
+}
@@ -0,0 +1,37 @@
+#include "../Header/TextureArray.h"
+#include "../Header/GLState.h"
+#include <algorithm>
+#include <iostream>
+
+unsigned int createTextureArray(const DecodedImage* images, int count) {
+    if (count <= 0) return 0;
+
+    int width = images[0].width, height = images[0].height;
+    for (int i = 0; i < count; i++) {
+        if (images[i].width == 0) return 0; // already reported by decodeImages
+        if (images[i].width != width || images[i].height != height || images[i].levels != images[0].levels) {
+            std::cout << "Textura nije iste velicine kao ostale u nizu: " << images[i].path << std::endl;
+            return 0;
+        }
+    }
+
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    stateBindTexture(0, GL_TEXTURE_2D_ARRAY, tex);
+    // Mips come with the images, so each level is just a copy
+    int levels = images[0].levels;
+    for (int l = 0; l < levels; l++) {
+        int w = std::max(1, width >> l), h = std::max(1, height >> l);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, l, GL_RGBA8, w, h, count, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        for (int i = 0; i < count; i++) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, l, 0, 0, i, w, h, 1,
+                GL_RGBA, GL_UNSIGNED_BYTE, images[i].Level(l));
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return tex;
+}
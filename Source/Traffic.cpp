@@ -0,0 +1,151 @@
+#include "../Header/Traffic.h"
+#include <cmath>
+#include <random>
+
+static const double HOUR = 3600.0;
+
+// Rate (multiple of the mean) and trip mix at some moment
+struct TrafficMix {
+    double rate;
+    double incoming; // share of trips from the lobby up
+    double outgoing; // share of trips down to the lobby; the rest is inter-floor
+};
+
+// TRAFFIC_DAY by the hour from midnight, interpolated between hour midpoints
+static const TrafficMix DAY_MIX[24] = {
+    {0.05, 0.2, 0.4}, {0.05, 0.2, 0.4}, {0.05, 0.2, 0.4}, {0.05, 0.2, 0.4},
+    {0.05, 0.3, 0.3}, {0.1, 0.5, 0.2}, {0.3, 0.7, 0.1}, {1.0, 0.8, 0.05},
+    {2.5, 0.85, 0.05},  // 8-9 h up-peak
+    {1.0, 0.5, 0.1}, {0.6, 0.2, 0.2}, {0.7, 0.2, 0.3},
+    {1.8, 0.4, 0.45},   // 12-13 h lunch
+    {1.2, 0.5, 0.25}, {0.6, 0.2, 0.2}, {0.6, 0.15, 0.3}, {1.0, 0.1, 0.55},
+    {2.5, 0.05, 0.85},  // 17-18 h down-peak
+    {0.8, 0.05, 0.75}, {0.3, 0.1, 0.6}, {0.15, 0.1, 0.5}, {0.1, 0.1, 0.5},
+    {0.05, 0.1, 0.5}, {0.05, 0.2, 0.4},
+};
+
+static TrafficMix mixAt(TrafficProfile profile, double time) {
+    switch (profile) {
+    case TRAFFIC_INTERFLOOR: return {1.0, 0.0, 0.0};
+    case TRAFFIC_UP_PEAK: return {1.0, 0.85, 0.05};
+    case TRAFFIC_LUNCH: return {1.0, 0.4, 0.45};
+    case TRAFFIC_DOWN_PEAK: return {1.0, 0.05, 0.85};
+    default: break;
+    }
+
+    double hour = fmod(time / HOUR, 24.0) - 0.5;
+    if (hour < 0.0) hour += 24.0;
+    int from = (int)hour;
+    int to = (from + 1) % 24;
+    double t = hour - from;
+    TrafficMix mix;
+    mix.rate = DAY_MIX[from].rate + (DAY_MIX[to].rate - DAY_MIX[from].rate) * t;
+    mix.incoming = DAY_MIX[from].incoming + (DAY_MIX[to].incoming - DAY_MIX[from].incoming) * t;
+    mix.outgoing = DAY_MIX[from].outgoing + (DAY_MIX[to].outgoing - DAY_MIX[from].outgoing) * t;
+    return mix;
+}
+
+static double peakRate(TrafficProfile profile) {
+    if (profile != TRAFFIC_DAY) return 1.0;
+    double peak = 0.0;
+    for (const TrafficMix& m : DAY_MIX)
+        if (m.rate > peak) peak = m.rate;
+    return peak;
+}
+
+const char* trafficProfileName(TrafficProfile profile) {
+    switch (profile) {
+    case TRAFFIC_INTERFLOOR: return "interfloor";
+    case TRAFFIC_UP_PEAK: return "up-peak";
+    case TRAFFIC_LUNCH: return "lunch";
+    case TRAFFIC_DOWN_PEAK: return "down-peak";
+    default: return "day";
+    }
+}
+
+std::vector<PassengerArrival> generateTraffic(TrafficProfile profile, double duration,
+                                              double ratePerHour, unsigned int seed) {
+    std::vector<PassengerArrival> arrivals;
+    if (duration <= 0.0 || ratePerHour <= 0.0) return arrivals;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    // Floors other than the lobby, numbered 0..NUM_FLOORS-2 and shifted past it
+    std::uniform_int_distribution<int> upperPick(0, NUM_FLOORS - 2);
+    std::uniform_int_distribution<int> otherPick(0, NUM_FLOORS - 3);
+
+    // Candidates at the highest rate, each kept with probability rate(t) / highest
+    double maxRate = ratePerHour * peakRate(profile) / HOUR;
+    std::exponential_distribution<double> nextGap(maxRate);
+
+    for (double t = nextGap(rng); t < duration; t += nextGap(rng)) {
+        TrafficMix mix = mixAt(profile, t);
+        if (unit(rng) * maxRate >= mix.rate * ratePerHour / HOUR) continue;
+
+        PassengerArrival a;
+        a.time = t;
+        int floor = upperPick(rng);
+        if (floor >= LOBBY_FLOOR) floor++;
+
+        double kind = unit(rng);
+        if (kind < mix.incoming) {
+            a.origin = LOBBY_FLOOR;
+            a.destination = floor;
+        } else if (kind < mix.incoming + mix.outgoing) {
+            a.origin = floor;
+            a.destination = LOBBY_FLOOR;
+        } else {
+            // Another upper floor: skip the lobby and the origin
+            int other = otherPick(rng);
+            int low = floor < LOBBY_FLOOR ? floor : LOBBY_FLOOR;
+            int high = floor < LOBBY_FLOOR ? LOBBY_FLOOR : floor;
+            if (other >= low) other++;
+            if (other >= high) other++;
+            a.origin = floor;
+            a.destination = other;
+        }
+        arrivals.push_back(a);
+    }
+    return arrivals;
+}
+
+PassengerFlow::PassengerFlow(const std::vector<PassengerArrival>& arrivals, int carCount)
+    : arrivals(arrivals), nextArrival(0), carCount(carCount),
+      waiting(carCount * NUM_FLOORS), riding(carCount * NUM_FLOORS)
+{
+}
+
+double PassengerFlow::NextArrival() const {
+    return nextArrival < arrivals.size() ? arrivals[nextArrival].time : -1.0;
+}
+
+void PassengerFlow::Issue(ElevatorGroup& group, double now) {
+    while (nextArrival < arrivals.size() && arrivals[nextArrival].time <= now) {
+        int car = group.CallToFloor(arrivals[nextArrival].origin);
+        if (car >= 0 && car < carCount)
+            waiting[car * NUM_FLOORS + arrivals[nextArrival].origin].push_back((int)nextArrival);
+        nextArrival++;
+    }
+}
+
+void PassengerFlow::Exchange(ElevatorGroup& group, double now) {
+    for (int c = 0; c < carCount && c < group.CarCount(); c++) {
+        Elevator& car = group.Car(c);
+        if (car.moving || !car.AreDoorsOpen()) continue;
+
+        std::vector<int>& leaving = riding[c * NUM_FLOORS + car.currentFloor];
+        for (int p : leaving)
+            journeyTimes.push_back(now - arrivals[p].time);
+        leaving.clear();
+
+        // Everyone boards before the first button press starts closing the doors
+        std::vector<int> boarding;
+        boarding.swap(waiting[c * NUM_FLOORS + car.currentFloor]);
+        for (int p : boarding) {
+            waitTimes.push_back(now - arrivals[p].time);
+            riding[c * NUM_FLOORS + arrivals[p].destination].push_back(p);
+        }
+        for (int p : boarding)
+            car.RequestFloor(arrivals[p].destination);
+    }
+}
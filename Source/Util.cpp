@@ -1,4 +1,5 @@
 #include "../Header/Util.h";
+#include "../Header/GLState.h"
 
 #define _CRT_SECURE_NO_WARNINGS
 #include <fstream>
@@ -75,6 +76,10 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
 
+    // Let the linked binary be read back for the program cache (ShaderCache)
+    if (GLEW_ARB_get_program_binary)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(program); //Povezi ih u jedan objedinjeni sejder program
     glValidateProgram(program); //Izvrsi provjeru novopecenog programa
 
@@ -119,9 +124,8 @@ unsigned loadImageToTexture(const char* filePath) {
 
         unsigned int Texture;
         glGenTextures(1, &Texture);
-        glBindTexture(GL_TEXTURE_2D, Texture);
+        stateBindTexture(0, GL_TEXTURE_2D, Texture);
         glTexImage2D(GL_TEXTURE_2D, 0, InternalFormat, TextureWidth, TextureHeight, 0, InternalFormat, GL_UNSIGNED_BYTE, ImageData);
-        glBindTexture(GL_TEXTURE_2D, 0);
         // oslobadjanje memorije zauzete sa stbi_load posto vise nije potrebna
         stbi_image_free(ImageData);
         return Texture;
@@ -0,0 +1,41 @@
+#include "../Header/Visibility.h"
+
+int VisibilityTable::key(int floor, bool inElevator, bool doorsOpen) {
+    return (floor * 2 + (inElevator ? 1 : 0)) * 2 + (doorsOpen ? 1 : 0);
+}
+
+void VisibilityTable::Build() {
+    sets.assign(NUM_FLOORS * 4, VisibleSet());
+
+    for (int floor = 0; floor < NUM_FLOORS; floor++) {
+        for (int inside = 0; inside < 2; inside++) {
+            for (int open = 0; open < 2; open++) {
+                VisibleSet& v = sets[key(floor, inside != 0, open != 0)];
+
+                if (!inside) {
+                    // Hallway: own floor, plus a view into the open shaft where the cab may be
+                    v.firstFloor = v.lastFloor = floor;
+                    v.shaft = true;
+                    v.cab = true;
+                } else if (open) {
+                    // Cab with doors open: the cab and the floor it opens onto
+                    v.firstFloor = v.lastFloor = floor;
+                    v.shaft = false;
+                    v.cab = true;
+                } else {
+                    // Closed cab: nothing outside it can be seen
+                    v.firstFloor = 0;
+                    v.lastFloor = -1;
+                    v.shaft = false;
+                    v.cab = true;
+                }
+            }
+        }
+    }
+}
+
+const VisibleSet& VisibilityTable::Query(int floor, bool inElevator, bool doorsOpen) const {
+    if (floor < 0) floor = 0;
+    if (floor >= NUM_FLOORS) floor = NUM_FLOORS - 1;
+    return sets[key(floor, inElevator, doorsOpen)];
+}